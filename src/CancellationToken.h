@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+// Cooperative cancellation for solve requests. A token is cancelled either
+// explicitly through cancel() or once its deadline has passed. Solvers poll
+// is_cancelled() between units of work, so one token may be shared by
+// several solves running on different threads.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    std::atomic<bool> cancelled{false};
+    std::atomic<Clock::rep> deadline{Clock::time_point::max().time_since_epoch().count()};
+
+public:
+    CancellationToken() = default;
+
+    explicit CancellationToken(double timeout_seconds) {
+        set_timeout(timeout_seconds);
+    }
+
+    void cancel() {
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    void set_deadline(Clock::time_point time) {
+        deadline.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Timeouts beyond the clock's range never expire and negative ones have
+    // already expired. NaN is rejected and leaves the deadline unchanged.
+    bool set_timeout(double seconds) {
+        if (std::isnan(seconds)) {
+            return false;
+        }
+        Clock::time_point now = Clock::now();
+        std::chrono::duration<double> left = Clock::time_point::max() - now;
+        if (seconds <= 0.0) {
+            set_deadline(now);
+        } else if (seconds >= left.count()) {
+            set_deadline(Clock::time_point::max());
+        } else {
+            set_deadline(now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+        }
+        return true;
+    }
+
+    bool is_cancelled() const {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        return Clock::now().time_since_epoch().count() >= deadline.load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,253 @@
+#include "Checkpoint.h"
+#include "Tables.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
+const char CHECKPOINT_MAGIC[8] = {'R', 'C', 'C', 'K', 'P', 'T', '0', '0'};
+const uint32_t CHECKPOINT_VERSION = 4;
+
+// Smallest encodings, used to reject counts the rest of the data cannot hold
+const size_t MIN_STRING_SIZE = sizeof(uint32_t);
+const size_t MIN_CUBE_SIZE = N_STICKERS + sizeof(int32_t) + sizeof(uint32_t);
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+template <typename T>
+static void write_value(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool read_value(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Bytes left to read, so that counts from the file can be checked before allocating
+static size_t remaining(std::istream& in) {
+    std::streampos pos = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streampos end = in.tellg();
+    in.seekg(pos);
+    return pos < 0 || end < pos ? 0 : static_cast<size_t>(end - pos);
+}
+
+static bool fits(std::istream& in, uint32_t count, size_t item_size) {
+    return static_cast<uint64_t>(count) * item_size <= remaining(in);
+}
+
+static void write_string(std::ostream& out, const std::string& s) {
+    write_value(out, static_cast<uint32_t>(s.size()));
+    out.write(s.data(), s.size());
+}
+
+static bool read_string(std::istream& in, std::string& s) {
+    uint32_t size;
+    if (!read_value(in, size) || !fits(in, size, 1)) {
+        return false;
+    }
+    s.resize(size);
+    return static_cast<bool>(in.read(&s[0], size));
+}
+
+static void write_moves(std::ostream& out, const std::vector<std::string>& moves) {
+    write_value(out, static_cast<uint32_t>(moves.size()));
+    for (const auto& m : moves) {
+        write_string(out, m);
+    }
+}
+
+static bool read_moves(std::istream& in, std::vector<std::string>& moves) {
+    uint32_t size;
+    if (!read_value(in, size) || !fits(in, size, MIN_STRING_SIZE)) {
+        return false;
+    }
+    moves.resize(size);
+    for (auto& m : moves) {
+        if (!read_string(in, m)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void write_cube(std::ostream& out, const Cube& cube) {
+    out.write(cube.stickers.data(), cube.stickers.size());
+    write_value(out, static_cast<int32_t>(cube.fitness));
+    write_value(out, static_cast<uint32_t>(cube.move_history.size()));
+    for (const auto& segment : cube.move_history) {
+        write_moves(out, segment);
+    }
+}
+
+static bool read_cube(std::istream& in, Cube& cube) {
+    if (!in.read(cube.stickers.data(), cube.stickers.size())) {
+        return false;
+    }
+    int32_t fitness;
+    uint32_t segments;
+    if (!read_value(in, fitness) || !read_value(in, segments) || !fits(in, segments, sizeof(uint32_t))) {
+        return false;
+    }
+    cube.fitness = fitness;
+    cube.move_history.resize(segments);
+    for (auto& segment : cube.move_history) {
+        if (!read_moves(in, segment)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    bool SolverCheckpoint::save(const std::string& path) const {
+        std::ostringstream out(std::ios::binary);
+        write_moves(out, scramble);
+        write_value(out, static_cast<int32_t>(population_size));
+        write_value(out, static_cast<int32_t>(max_generations));
+        write_value(out, static_cast<int32_t>(max_resets));
+        write_value(out, static_cast<int32_t>(elitism_num));
+        write_value(out, static_cast<int32_t>(stagnation_limit));
+        write_value(out, crossover_rate);
+
+        write_value(out, static_cast<int32_t>(world));
+        write_value(out, static_cast<int32_t>(generation));
+        write_value(out, static_cast<int32_t>(world_best));
+        write_value(out, static_cast<int32_t>(stagnation));
+        write_value(out, seconds);
+        write_value(out, static_cast<uint32_t>(evolution_weights.size()));
+        for (double w : evolution_weights) {
+            write_value(out, w);
+        }
+        write_string(out, rng_state);
+
+        write_value(out, static_cast<int32_t>(best.fitness));
+        write_value(out, static_cast<int32_t>(best.world));
+        write_value(out, static_cast<int32_t>(best.generation));
+        write_moves(out, best.solution);
+
+        write_value(out, static_cast<uint32_t>(population.size()));
+        for (const auto& cube : population) {
+            write_cube(out, cube);
+        }
+        std::string payload = out.str();
+
+        // Write to a temporary file first so a crash never leaves a truncated checkpoint
+        std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+            write_value(file, CHECKPOINT_VERSION);
+            write_value(file, static_cast<uint64_t>(payload.size()));
+            write_value(file, TableSet::checksum(reinterpret_cast<const uint8_t*>(payload.data()), payload.size()));
+            file.write(payload.data(), payload.size());
+
+            if (!file) {
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+        }
+        return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+    }
+
+    bool SolverCheckpoint::load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        char magic[sizeof(CHECKPOINT_MAGIC)];
+        uint32_t version;
+        uint64_t payload_size;
+        uint64_t payload_checksum;
+        if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC)
+            || !read_value(file, version) || version != CHECKPOINT_VERSION
+            || !read_value(file, payload_size) || !read_value(file, payload_checksum)
+            || payload_size != remaining(file)) {
+            return false;
+        }
+
+        // The payload is verified as a whole before any of it is parsed
+        std::string payload(payload_size, '\0');
+        if (!file.read(&payload[0], payload_size)
+            || TableSet::checksum(reinterpret_cast<const uint8_t*>(payload.data()), payload.size())
+                != payload_checksum) {
+            return false;
+        }
+        std::istringstream in(payload, std::ios::binary);
+
+        int32_t config[5];
+        int32_t progress[4];
+        if (!read_moves(in, scramble)) {
+            return false;
+        }
+        for (int32_t& v : config) {
+            if (!read_value(in, v)) {
+                return false;
+            }
+        }
+        if (!read_value(in, crossover_rate)) {
+            return false;
+        }
+        for (int32_t& v : progress) {
+            if (!read_value(in, v)) {
+                return false;
+            }
+        }
+        population_size = config[0];
+        max_generations = config[1];
+        max_resets = config[2];
+        elitism_num = config[3];
+        stagnation_limit = config[4];
+        world = progress[0];
+        generation = progress[1];
+        world_best = progress[2];
+        stagnation = progress[3];
+
+        uint32_t n_weights;
+        if (!read_value(in, seconds) || !read_value(in, n_weights) || !fits(in, n_weights, sizeof(double))) {
+            return false;
+        }
+        evolution_weights.resize(n_weights);
+        for (double& w : evolution_weights) {
+            if (!read_value(in, w)) {
+                return false;
+            }
+        }
+        if (!read_string(in, rng_state)) {
+            return false;
+        }
+
+        int32_t best_values[3];
+        for (int32_t& v : best_values) {
+            if (!read_value(in, v)) {
+                return false;
+            }
+        }
+        best = SolveResult();
+        best.scramble = scramble;
+        best.fitness = best_values[0];
+        best.world = best_values[1];
+        best.generation = best_values[2];
+        if (!read_moves(in, best.solution)) {
+            return false;
+        }
+
+        uint32_t n_cubes;
+        if (!read_value(in, n_cubes) || static_cast<int>(n_cubes) != population_size
+            || !fits(in, n_cubes, MIN_CUBE_SIZE)) {
+            return false;
+        }
+        population.assign(n_cubes, Cube());
+        for (auto& cube : population) {
+            if (!read_cube(in, cube)) {
+                return false;
+            }
+        }
+        return true;
+    }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Cube.h"
+#include "Solver.h"
+#include <string>
+#include <vector>
+
+// Snapshot of a genetic solve taken at the start of a generation, before the
+// population is sorted. Restoring it together with the RNG state continues
+// the run exactly as if it had never stopped.
+struct SolverCheckpoint {
+    // Configuration of the run, a checkpoint only resumes an identical one
+    std::vector<std::string> scramble;
+    int population_size = 0;
+    int max_generations = 0;
+    int max_resets = 0;
+    int elitism_num = 0;
+    int stagnation_limit = 0;
+    double crossover_rate = 0.0;
+
+    // Progress
+    int world = 0;          // zero based world and generation about to run
+    int generation = 0;
+    int world_best = -1;
+    int stagnation = 0;
+    double seconds = 0.0;   // solve time spent before the snapshot
+    std::vector<double> evolution_weights;
+    std::string rng_state;  // std::mt19937 state as written by operator<<
+    SolveResult best;       // best individual seen so far
+    std::vector<Cube> population;
+
+    // Binary format: magic, version, payload size and checksum, then the
+    // payload with the fields above in order. Cubes are stored as 54 sticker
+    // bytes followed by their move history. load() returns false for a
+    // corrupt file, it checks the checksum and every count before allocating.
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
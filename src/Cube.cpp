@@ -1,114 +1,38 @@
 #include "Cube.h"
 
 // Constants
-const std::string GREEN = "G";
-const std::string ORANGE = "O";
-const std::string RED = "R";
-const std::string WHITE = "W";
-const std::string YELLOW = "Y";
-const std::string BLUE = "B";
+const char GREEN = 'G';
+const char ORANGE = 'O';
+const char RED = 'R';
+const char WHITE = 'W';
+const char YELLOW = 'Y';
+const char BLUE = 'B';
 
-const std::string FRONT = "FRONT";
-const std::string LEFT = "LEFT";
-const std::string BACK = "BACK";
-const std::string RIGHT = "RIGHT";
-const std::string TOP = "TOP";
-const std::string BOTTOM = "BOTTOM";
+// Face names in the order of the Face enum
+const std::array<std::string, 6> FACE_NAMES = {"TOP", "RIGHT", "FRONT", "BOTTOM", "LEFT", "BACK"};
 
 
-using Rotation = std::pair<int, int>;
-const Rotation CLOCKWISE = {1, 0};
-const Rotation COUNTERCLOCKWISE = {0, 1};
-
-
-    // Constructor initialises faces and the move references in moves_lookup
+    // Constructor initialises every face to its colour
     Cube::Cube() {
-        // Initialize all faces to their respective colors
-        faces[FRONT] = {{{GREEN, GREEN, GREEN}, {GREEN, GREEN, GREEN}, {GREEN, GREEN, GREEN}}};
-        faces[LEFT] = {{{ORANGE, ORANGE, ORANGE}, {ORANGE, ORANGE, ORANGE}, {ORANGE, ORANGE, ORANGE}}};
-        faces[RIGHT] = {{{RED, RED, RED}, {RED, RED, RED}, {RED, RED, RED}}};
-        faces[TOP] = {{{WHITE, WHITE, WHITE}, {WHITE, WHITE, WHITE}, {WHITE, WHITE, WHITE}}};
-        faces[BOTTOM] = {{{YELLOW, YELLOW, YELLOW}, {YELLOW, YELLOW, YELLOW}, {YELLOW, YELLOW, YELLOW}}};
-        faces[BACK] = {{{BLUE, BLUE, BLUE}, {BLUE, BLUE, BLUE}, {BLUE, BLUE, BLUE}}};
-
-         // Horizontal moves
-        moves_lookup["D"] = &Cube::D;
-        moves_lookup["D'"] = &Cube::D_prime;
-        moves_lookup["D2"] = &Cube::D2;
-
-        moves_lookup["E"] = &Cube::E;
-        moves_lookup["E'"] = &Cube::E_prime;
-        moves_lookup["E2"] = &Cube::E2;
-
-        moves_lookup["U"] = &Cube::U;
-        moves_lookup["U'"] = &Cube::U_prime;
-        moves_lookup["U2"] = &Cube::U2;
-
-        // Vertical moves
-        moves_lookup["L"] = &Cube::L;
-        moves_lookup["L'"] = &Cube::L_prime;
-        moves_lookup["L2"] = &Cube::L2;
-
-        moves_lookup["R"] = &Cube::R;
-        moves_lookup["R'"] = &Cube::R_prime;
-        moves_lookup["R2"] = &Cube::R2;
-
-        moves_lookup["M"] = &Cube::M;
-        moves_lookup["M'"] = &Cube::M_prime;
-        moves_lookup["M2"] = &Cube::M2;
-
-        // Z moves
-        moves_lookup["B"] = &Cube::B;
-        moves_lookup["B'"] = &Cube::B_prime;
-        moves_lookup["B2"] = &Cube::B2;
-
-        moves_lookup["F"] = &Cube::F;
-        moves_lookup["F'"] = &Cube::F_prime;
-        moves_lookup["F2"] = &Cube::F2;
-
-        moves_lookup["S"] = &Cube::S;
-        moves_lookup["S'"] = &Cube::S_prime;
-        moves_lookup["S2"] = &Cube::S2;
-
-        // Full rotations
-        moves_lookup["x"] = &Cube::x_full;
-        moves_lookup["x'"] = &Cube::x_prime_full;
-        moves_lookup["x2"] = &Cube::x2_full;
-
-        moves_lookup["y"] = &Cube::y_full;
-        moves_lookup["y'"] = &Cube::y_prime_full;
-        moves_lookup["y2"] = &Cube::y2_full;
-
-        moves_lookup["z"] = &Cube::z_full;
-        moves_lookup["z'"] = &Cube::z_prime_full;
-        moves_lookup["z2"] = &Cube::z2_full;
-        
-        
+        const std::array<char, 6> colors = {WHITE, RED, GREEN, YELLOW, ORANGE, BLUE};
+        for (int i = 0; i < N_STICKERS; ++i) {
+            stickers[i] = colors[i / 9];
+        }
     }
-    
+
     bool Cube::operator<(const Cube& other) const {
         return this->fitness < other.fitness;
     }
 
-    Cube& Cube::operator=(const Cube& other) {
-    if (this != &other) { // Check for self-assignment
-        // Copy each member from 'other' into 'this'
-        faces = other.faces;
-        moves_lookup = other.moves_lookup;
-        move_history = other.move_history;
-        fitness = other.fitness;
-        // add any other members as needed
-    }
-    return *this;
-}
 // ---------------------------------------------------------------------------
 // Core Functions
 // ---------------------------------------------------------------------------
 
     void Cube::execute(const std::vector<std::string>& moves) {
         for (const auto& m : moves) {
-            if (moves_lookup.find(m) != moves_lookup.end()) {
-                (this->*moves_lookup[m])(); // Call the move function using a member function pointer
+            Move move;
+            if (parse_move(m.c_str(), m.size(), move)) {
+                apply(move);
             } else {
                 // Handle invalid move here, if necessary
                 // e.g., std::cerr << "Invalid move: " << m << std::endl;
@@ -119,391 +43,114 @@ const Rotation COUNTERCLOCKWISE = {0, 1};
         calculate_fitness();
     }
 
-    void Cube::calculate_fitness() {
-        int misplaced_stickers = 0;
-
-        for (const auto& face_pair : faces) {
-            const Face& face = face_pair.second;
-            // centers are fixed in a Rubik cube
-            std::string center = face[1][1];
-
-            for (int i = 0; i < 3; ++i) {
-                for (int j = 0; j < 3; ++j) {
-                    if (face[i][j] != center) {
-                        misplaced_stickers++;
-                    }
-                }
-            }
-        }
-
-    fitness = misplaced_stickers;
+    void Cube::execute(Move move) {
+        apply(move);
+        record({MOVE_NAMES[static_cast<int>(move)]});
     }
 
-    bool Cube::is_solved() const {
-        return fitness == 0;
+    void Cube::record(const std::vector<std::string>& moves) {
+        move_history.push_back(moves);
+        calculate_fitness();
     }
 
-
-
-    // Rotate a face 90 degrees
-    void Cube::rotate90(Face& face, int direction) {
-        Face temp = face;
-        if (direction == CLOCKWISE) {
-            for (int i = 0; i < 3; ++i) {
-                for (int j = 0; j < 3; ++j) {
-                    face[j][2 - i] = temp[i][j];
-                }
-            }
-        } else { // COUNTERCLOCKWISE
-            for (int i = 0; i < 3; ++i) {
-                for (int j = 0; j < 3; ++j) {
-                    face[2 - j][i] = temp[i][j];
+    void Cube::replay(const Stickers& scrambled) {
+        stickers = scrambled;
+        for (size_t i = 1; i < move_history.size(); ++i) {
+            for (const auto& m : move_history[i]) {
+                Move move;
+                if (parse_move(m.c_str(), m.size(), move)) {
+                    apply(move);
                 }
             }
         }
-    }
-// ---------------------------------------------------------------------------
-// X Axis movements - D, E and U
-// ---------------------------------------------------------------------------
-
-    void Cube::D() {
-        rotate90(faces["BOTTOM"], CLOCKWISE);
-        swap_x({"FRONT", 2}, {"RIGHT", 2}, {"BACK", 2}, {"LEFT", 2});
-    }
-
-    void Cube::D_prime() {
-        rotate90(faces["BOTTOM"], COUNTERCLOCKWISE);
-        swap_x({"FRONT", 2}, {"LEFT", 2}, {"BACK", 2}, {"RIGHT", 2});
-    }
-
-    void Cube::D2() {
-        D();
-        D();
-    }
-
-    void Cube::E() {
-        swap_x({"FRONT", 1}, {"RIGHT", 1}, {"BACK", 1}, {"LEFT", 1});
-    }
-
-    void Cube::E_prime() {
-        swap_x({"FRONT", 1}, {"LEFT", 1}, {"BACK", 1}, {"RIGHT", 1});
-    }
-
-    void Cube::E2() {
-        E();
-        E();
-    }
-
-    void Cube::U() {
-        rotate90(faces["TOP"], CLOCKWISE);
-        swap_x({"FRONT", 0}, {"LEFT", 0}, {"BACK", 0}, {"RIGHT", 0});
-    }
-
-    void Cube::U_prime() {
-        rotate90(faces["TOP"], COUNTERCLOCKWISE);
-        swap_x({"FRONT", 0}, {"RIGHT", 0}, {"BACK", 0}, {"LEFT", 0});
-    }
-
-    void Cube::U2() {
-        U();
-        U();
+        calculate_fitness();
     }
 
-    void Cube::swap_x(const std::pair<std::string, int>& t1, 
-            const std::pair<std::string, int>& t2, 
-            const std::pair<std::string, int>& t3, 
-            const std::pair<std::string, int>& t4) {
-        // Create a backup array
-        std::array<std::string, 3> backup;
-        
-        // Perform the copying/swapping operations
-        copy_stickers(backup, faces[t4.first][t4.second]);
-        copy_stickers(faces[t4.first][t4.second], faces[t3.first][t3.second]);
-        copy_stickers(faces[t3.first][t3.second], faces[t2.first][t2.second]);
-        copy_stickers(faces[t2.first][t2.second], faces[t1.first][t1.second]);
-        copy_stickers(faces[t1.first][t1.second], backup);
-    }
+    void Cube::calculate_fitness() {
+        int misplaced_stickers = 0;
 
-    void Cube::copy_stickers(std::array<std::string, 3>& destination, const std::array<std::string, 3>& origin) {
-            destination[0] = origin[0];
-            destination[1] = origin[1];
-            destination[2] = origin[2];
+        for (int face = 0; face < 6; ++face) {
+            // centers are fixed in a Rubik cube
+            char center = stickers[face * 9 + 4];
+            for (int i = face * 9; i < face * 9 + 9; ++i) {
+                if (stickers[i] != center) {
+                    misplaced_stickers++;
+                }
+            }
         }
 
-// ---------------------------------------------------------------------------
-// Y Axis movements - L, M and R
-// ---------------------------------------------------------------------------
-
-    void Cube::L() {
-        rotate90(faces["LEFT"], CLOCKWISE);
-        swap_y({"BOTTOM", 0, true}, {"BACK", 2, true}, {"TOP", 0, false}, {"FRONT", 0, false});
-    }
-
-    void Cube::L_prime() {
-        rotate90(faces["LEFT"], COUNTERCLOCKWISE);
-        swap_y({"BOTTOM", 0, false}, {"FRONT", 0, false}, {"TOP", 0, true}, {"BACK", 2, true});
-    }
-
-    void Cube::L2() {
-        L();
-        L();
-    }
-
-    void Cube::M() {
-        swap_y({"BOTTOM", 1, true}, {"BACK", 1, true}, {"TOP", 1, false}, {"FRONT", 1, false});
-    }
-
-    void Cube::M_prime() {
-        swap_y({"BOTTOM", 1, false}, {"FRONT", 1, false}, {"TOP", 1, true}, {"BACK", 1, true});
-    }
-
-    void Cube::M2() {
-        M();
-        M();
-    }
-
-    void Cube::R() {
-        rotate90(faces["RIGHT"], CLOCKWISE);
-        swap_y({"BOTTOM", 2, false}, {"FRONT", 2, false}, {"TOP", 2, true}, {"BACK", 0, true});
-    }
-
-    void Cube::R_prime() {
-        rotate90(faces["RIGHT"], COUNTERCLOCKWISE);
-        swap_y({"BOTTOM", 2, true}, {"BACK", 0, true}, {"TOP", 2, false}, {"FRONT", 2, false});
-    }
-
-    void Cube::R2() {
-        R();
-        R();
+        fitness = misplaced_stickers;
     }
 
-void Cube::swap_y(const std::tuple<std::string, int, bool>& t1, 
-            const std::tuple<std::string, int, bool>& t2, 
-            const std::tuple<std::string, int, bool>& t3, 
-            const std::tuple<std::string, int, bool>& t4) {
-    
-    std::array<std::string, 3> backup;
-    
-    // Fetch column and possibly flip it
-    if (std::get<2>(t1)) {
-        for (int i = 0; i < 3; ++i) {
-            backup[2-i] = faces[std::get<0>(t1)][i][std::get<1>(t1)];
-        }
-    } else {
-        for (int i = 0; i < 3; ++i) {
-            backup[i] = faces[std::get<0>(t1)][i][std::get<1>(t1)];
-        }
-    }
-    
-    // Swap columns
-    if (std::get<2>(t4)) {
-        for (int i = 0; i < 3; ++i) {
-            faces[std::get<0>(t1)][i][std::get<1>(t1)] = faces[std::get<0>(t4)][2-i][std::get<1>(t4)];
-        }
-    } else {
-        for (int i = 0; i < 3; ++i) {
-            faces[std::get<0>(t1)][i][std::get<1>(t1)] = faces[std::get<0>(t4)][i][std::get<1>(t4)];
-        }
-    }
-
-    if (std::get<2>(t3)) {
-        for (int i = 0; i < 3; ++i) {
-            faces[std::get<0>(t4)][i][std::get<1>(t4)] = faces[std::get<0>(t3)][2-i][std::get<1>(t3)];
-        }
-    } else {
-        for (int i = 0; i < 3; ++i) {
-            faces[std::get<0>(t4)][i][std::get<1>(t4)] = faces[std::get<0>(t3)][i][std::get<1>(t3)];
-        }
+    bool Cube::is_solved() const {
+        return fitness == 0;
     }
 
-    if (std::get<2>(t2)) {
-        for (int i = 0; i < 3; ++i) {
-            faces[std::get<0>(t3)][i][std::get<1>(t3)] = faces[std::get<0>(t2)][2-i][std::get<1>(t2)];
+    // Runtime dispatch onto the compile-time generated kernels
+    void Cube::apply(Move move) {
+        switch (move) {
+            // X Axis movements
+            case Move::U:       apply<Move::U>(); break;
+            case Move::U_PRIME: apply<Move::U_PRIME>(); break;
+            case Move::U2:      apply<Move::U2>(); break;
+            case Move::D:       apply<Move::D>(); break;
+            case Move::D_PRIME: apply<Move::D_PRIME>(); break;
+            case Move::D2:      apply<Move::D2>(); break;
+            case Move::E:       apply<Move::E>(); break;
+            case Move::E_PRIME: apply<Move::E_PRIME>(); break;
+            case Move::E2:      apply<Move::E2>(); break;
+
+            // Y Axis movements
+            case Move::L:       apply<Move::L>(); break;
+            case Move::L_PRIME: apply<Move::L_PRIME>(); break;
+            case Move::L2:      apply<Move::L2>(); break;
+            case Move::M:       apply<Move::M>(); break;
+            case Move::M_PRIME: apply<Move::M_PRIME>(); break;
+            case Move::M2:      apply<Move::M2>(); break;
+            case Move::R:       apply<Move::R>(); break;
+            case Move::R_PRIME: apply<Move::R_PRIME>(); break;
+            case Move::R2:      apply<Move::R2>(); break;
+
+            // Z Axis movements
+            case Move::F:       apply<Move::F>(); break;
+            case Move::F_PRIME: apply<Move::F_PRIME>(); break;
+            case Move::F2:      apply<Move::F2>(); break;
+            case Move::B:       apply<Move::B>(); break;
+            case Move::B_PRIME: apply<Move::B_PRIME>(); break;
+            case Move::B2:      apply<Move::B2>(); break;
+            case Move::S:       apply<Move::S>(); break;
+            case Move::S_PRIME: apply<Move::S_PRIME>(); break;
+            case Move::S2:      apply<Move::S2>(); break;
+
+            // Full Rotations
+            case Move::X:       apply<Move::X>(); break;
+            case Move::X_PRIME: apply<Move::X_PRIME>(); break;
+            case Move::X2:      apply<Move::X2>(); break;
+            case Move::Y:       apply<Move::Y>(); break;
+            case Move::Y_PRIME: apply<Move::Y_PRIME>(); break;
+            case Move::Y2:      apply<Move::Y2>(); break;
+            case Move::Z:       apply<Move::Z>(); break;
+            case Move::Z_PRIME: apply<Move::Z_PRIME>(); break;
+            case Move::Z2:      apply<Move::Z2>(); break;
         }
-    } else {
-        for (int i = 0; i < 3; ++i) {
-            faces[std::get<0>(t3)][i][std::get<1>(t3)] = faces[std::get<0>(t2)][i][std::get<1>(t2)];
-        }
-    }
-    
-    // Assign backup to the last face
-    for (int i = 0; i < 3; ++i) {
-        faces[std::get<0>(t2)][i][std::get<1>(t2)] = backup[i];
-    }
-}
-
-    void copy_stickers_flip(std::array<std::string, 3>& destination, const std::array<std::string, 3>& origin) {
-        destination[0] = origin[2];
-        destination[1] = origin[1];
-        destination[2] = origin[0];
-    }
-// ---------------------------------------------------------------------------
-// Z Axis movements - B and F
-// ---------------------------------------------------------------------------
-    
-    void Cube::B() {
-        rotate90(faces["BACK"], CLOCKWISE);
-        swap_z({"BOTTOM", 2, true}, {"RIGHT", 2, false}, {"TOP", 0, true}, {"LEFT", 0, false});
-    }
-
-    void Cube::B_prime() {
-        rotate90(faces["BACK"], COUNTERCLOCKWISE);
-        swap_z({"BOTTOM", 2, false}, {"LEFT", 0, true}, {"TOP", 0, false}, {"RIGHT", 2, true});
-    }
-
-    void Cube::B2() {
-        B();
-        B();
-    }
-
-    void Cube::F() {
-        rotate90(faces["FRONT"], CLOCKWISE);
-        swap_z({"BOTTOM", 0, false}, {"LEFT", 2, true}, {"TOP", 2, false}, {"RIGHT", 0, true});
-    }
-
-    void Cube::F_prime() {
-        rotate90(faces["FRONT"], COUNTERCLOCKWISE);
-        swap_z({"BOTTOM", 0, true}, {"RIGHT", 0, false}, {"TOP", 2, true}, {"LEFT", 2, false});
-    }
-
-    void Cube::F2() {
-        F();
-        F();
-    }
-
-    void Cube::S() {
-        swap_z({"BOTTOM", 1, false}, {"LEFT", 1, true}, {"TOP", 1, false}, {"RIGHT", 1, true});
-    }
-
-    void Cube::S_prime() {
-        swap_z({"BOTTOM", 1, true}, {"RIGHT", 1, false}, {"TOP", 1, true}, {"LEFT", 1, false});
-    }
-
-    void Cube::S2() {
-        S();
-        S();
     }
 
-void Cube::swap_z(const std::tuple<std::string, int, bool>& t1,
-            const std::tuple<std::string, int, bool>& t2,
-            const std::tuple<std::string, int, bool>& t3,
-            const std::tuple<std::string, int, bool>& t4) {
-    std::array<std::string, 3> backup;
-
-    auto extract_data = [&](const std::tuple<std::string, int, bool>& t) -> std::array<std::string, 3> {
-        auto& face = faces[std::get<0>(t)];
-        int index = std::get<1>(t);
-        std::array<std::string, 3> values;
-
-        if(std::get<0>(t) == "LEFT" || std::get<0>(t) == "RIGHT") {
-            values[0] = face[0][index];
-            values[1] = face[1][index];
-            values[2] = face[2][index];
-        } else {
-            values = face[index];
-        }
-
-        if (std::get<2>(t)) { // If flip is needed
-            std::reverse(values.begin(), values.end());
-        }
-        return values;
-    };
-
-    auto set_data = [&](const std::tuple<std::string, int, bool>& t, const std::array<std::string, 3>& values) {
-        auto& face = faces[std::get<0>(t)];
-        int index = std::get<1>(t);
-        std::array<std::string, 3> set_values = values;
-
-        if(std::get<0>(t) == "LEFT" || std::get<0>(t) == "RIGHT") {
-            face[0][index] = set_values[0];
-            face[1][index] = set_values[1];
-            face[2][index] = set_values[2];
-        } else {
-            face[index] = set_values;
-        }
-    };
-
-    // Backup t4
-    backup = extract_data(t4);
-
-    // t3 to t4
-    set_data(t4, extract_data(t3));
-
-    // t2 to t3
-    set_data(t3, extract_data(t2));
-
-    // t1 to t2
-    set_data(t2, extract_data(t1));
-
-    // backup to t1
-    set_data(t1, backup);
-}
 
 // ---------------------------------------------------------------------------
-// Full Rotations
+// Utilities
 // ---------------------------------------------------------------------------
-    void Cube::x_full() {
-        L_prime();
-        M_prime();
-        R();
-    }
-
-    void Cube::x_prime_full() {
-        L();
-        M();
-        R_prime();
-    }
-
-    void Cube::x2_full() {
-        x_full();
-        x_full();
-    }
-
-    void Cube::y_full() {
-        U();
-        E_prime();
-        D_prime();
-    }
 
-    void Cube::y_prime_full() {
-        U_prime();
-        E();
-        D();
+    char Cube::get_sticker(Face face, int row, int col) const {
+        return stickers[static_cast<int>(face) * 9 + row * 3 + col];
     }
 
-    void Cube::y2_full() {
-        y_full();
-        y_full();
-    }
-
-    void Cube::z_full() {
-        F();
-        S();
-        B_prime();
-    }
-
-    void Cube::z_prime_full() {
-        F_prime();
-        S_prime();
-        B();
-    }
-
-    void Cube::z2_full() {
-        z_full();
-        z_full();
-    }
-
-
-// ---------------------------------------------------------------------------
-// Utilities
-// ---------------------------------------------------------------------------
-
     std::string Cube::get_face_as_str(const std::string& face) const {
-        const Face& m = faces.at(face);
+        int f = static_cast<int>(std::find(FACE_NAMES.begin(), FACE_NAMES.end(), face) - FACE_NAMES.begin());
+        const char* m = stickers.data() + f * 9;
         std::ostringstream oss;
-        oss << m[0][0] << " " << m[0][1] << " " << m[0][2] << " - "
-            << m[1][0] << " " << m[1][1] << " " << m[1][2] << " - "
-            << m[2][0] << " " << m[2][1] << " " << m[2][2];
+        oss << m[0] << " " << m[1] << " " << m[2] << " - "
+            << m[3] << " " << m[4] << " " << m[5] << " - "
+            << m[6] << " " << m[7] << " " << m[8];
         return oss.str();
     }
 
@@ -532,18 +179,21 @@ void Cube::swap_z(const std::tuple<std::string, int, bool>& t1,
     std::ostream& operator<<(std::ostream& os, const Cube& cube) {
         os << "Scramble: " << cube.get_scramble_str() << "\n";
         os << "Algorithm: " << cube.get_algorithm_str() << "\n";
-        
-        std::vector<std::pair<std::string, Cube::Face>> faces_sorted(cube.faces.begin(), cube.faces.end());
+
+        std::vector<std::pair<std::string, int>> faces_sorted;
+        for (int f = 0; f < 6; ++f) {
+            faces_sorted.push_back({FACE_NAMES[f], f});
+        }
         std::sort(faces_sorted.begin(), faces_sorted.end());
-        
+
         for (const auto& pair : faces_sorted) {
             std::string face_name = pair.first;
-            const Cube::Face& face = pair.second;
-            os << std::setw(8) << std::left << (face_name + ":") << face[0][0] << " " << face[0][1] << " " << face[0][2] << "\n";
-            os << std::setw(8) << std::left << "" << face[1][0] << " " << face[1][1] << " " << face[1][2] << "\n";
-            os << std::setw(8) << std::left << "" << face[2][0] << " " << face[2][1] << " " << face[2][2] << "\n";
+            const char* face = cube.stickers.data() + pair.second * 9;
+            os << std::setw(8) << std::left << (face_name + ":") << face[0] << " " << face[1] << " " << face[2] << "\n";
+            os << std::setw(8) << std::left << "" << face[3] << " " << face[4] << " " << face[5] << "\n";
+            os << std::setw(8) << std::left << "" << face[6] << " " << face[7] << " " << face[8] << "\n";
         }
-        
+
         return os;
     }
 
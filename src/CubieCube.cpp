@@ -0,0 +1,370 @@
+#include "CubieCube.h"
+#include <unordered_map>
+
+// Faces in the order U, R, F, D, L, B
+const std::string FACE_LETTERS = "URFDLB";
+
+// Facelets are numbered like Cube's stickers, face * 9 + row * 3 + column.
+// Cube lays its faces out exactly like Kociemba's facelet net, so the
+// standard tables apply.
+const int CORNER_FACELETS[8][3] = {
+    {8, 9, 20},   // URF
+    {6, 18, 38},  // UFL
+    {0, 36, 47},  // ULB
+    {2, 45, 11},  // UBR
+    {29, 26, 15}, // DFR
+    {27, 44, 24}, // DLF
+    {33, 53, 42}, // DBL
+    {35, 17, 51}  // DRB
+};
+
+const int EDGE_FACELETS[12][2] = {
+    {5, 10},  // UR
+    {7, 19},  // UF
+    {3, 37},  // UL
+    {1, 46},  // UB
+    {32, 16}, // DR
+    {28, 25}, // DF
+    {30, 43}, // DL
+    {34, 52}, // DB
+    {23, 12}, // FR
+    {21, 41}, // FL
+    {50, 39}, // BL
+    {48, 14}  // BR
+};
+
+// Face each facelet of a solved cubie belongs to
+const int CORNER_COLORS[8][3] = {
+    {0, 1, 2}, {0, 2, 4}, {0, 4, 5}, {0, 5, 1},
+    {3, 2, 1}, {3, 4, 2}, {3, 5, 4}, {3, 1, 5}
+};
+
+const int EDGE_COLORS[12][2] = {
+    {0, 1}, {0, 2}, {0, 4}, {0, 5}, {3, 1}, {3, 2},
+    {3, 4}, {3, 5}, {2, 1}, {2, 4}, {5, 4}, {5, 1}
+};
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static int Cnk(int n, int k) {
+    if (k < 0 || n < k) {
+        return 0;
+    }
+    int result = 1;
+    for (int i = 1; i <= k; ++i) {
+        result = result * (n - k + i) / i;
+    }
+    return result;
+}
+
+// Lehmer code of a permutation of 0..n-1
+template <size_t N>
+static int perm_to_index(const std::array<int8_t, N>& perm, int offset, int n) {
+    int idx = 0;
+    for (int i = 0; i < n; ++i) {
+        int smaller = 0;
+        for (int j = i + 1; j < n; ++j) {
+            if (perm[offset + j] < perm[offset + i]) {
+                smaller++;
+            }
+        }
+        idx = idx * (n - i) + smaller;
+    }
+    return idx;
+}
+
+template <size_t N>
+static void index_to_perm(int idx, std::array<int8_t, N>& perm, int offset, int n, int first) {
+    int digits[12];
+    for (int i = n - 1; i >= 0; --i) {
+        digits[i] = idx % (n - i);
+        idx /= (n - i);
+    }
+    bool used[12] = {false};
+    for (int i = 0; i < n; ++i) {
+        int k = digits[i];
+        for (int v = 0; v < n; ++v) {
+            if (!used[v] && k-- == 0) {
+                used[v] = true;
+                perm[offset + i] = static_cast<int8_t>(first + v);
+                break;
+            }
+        }
+    }
+}
+
+template <size_t N>
+static int parity(const std::array<int8_t, N>& perm) {
+    int inversions = 0;
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i + 1; j < N; ++j) {
+            if (perm[j] < perm[i]) {
+                inversions++;
+            }
+        }
+    }
+    return inversions % 2;
+}
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    CubieCube::CubieCube() {
+        for (int i = 0; i < N_CORNERS; ++i) {
+            cp[i] = static_cast<int8_t>(i);
+            co[i] = 0;
+        }
+        for (int i = 0; i < N_EDGES; ++i) {
+            ep[i] = static_cast<int8_t>(i);
+            eo[i] = 0;
+        }
+    }
+
+    bool CubieCube::from_cube(const Cube& cube, CubieCube& result) {
+        // Map each center colour to the face it identifies
+        std::unordered_map<char, int> color_to_face;
+        for (int f = 0; f < 6; ++f) {
+            color_to_face[cube.stickers[f * 9 + 4]] = f;
+        }
+        if (color_to_face.size() != 6) {
+            return false;
+        }
+
+        int facelets[N_STICKERS];
+        for (int i = 0; i < N_STICKERS; ++i) {
+            auto it = color_to_face.find(cube.stickers[i]);
+            if (it == color_to_face.end()) {
+                return false;
+            }
+            facelets[i] = it->second;
+        }
+
+        result.cp.fill(-1);
+        result.ep.fill(-1);
+        for (int i = 0; i < N_CORNERS; ++i) {
+            int ori = 0;
+            while (ori < 3 && facelets[CORNER_FACELETS[i][ori]] != 0 && facelets[CORNER_FACELETS[i][ori]] != 3) {
+                ori++;
+            }
+            if (ori == 3) {
+                return false;
+            }
+            int col1 = facelets[CORNER_FACELETS[i][(ori + 1) % 3]];
+            int col2 = facelets[CORNER_FACELETS[i][(ori + 2) % 3]];
+            for (int j = 0; j < N_CORNERS; ++j) {
+                if (CORNER_COLORS[j][1] == col1 && CORNER_COLORS[j][2] == col2) {
+                    result.cp[i] = static_cast<int8_t>(j);
+                    result.co[i] = static_cast<int8_t>(ori);
+                    break;
+                }
+            }
+        }
+
+        for (int i = 0; i < N_EDGES; ++i) {
+            int col0 = facelets[EDGE_FACELETS[i][0]];
+            int col1 = facelets[EDGE_FACELETS[i][1]];
+            for (int j = 0; j < N_EDGES; ++j) {
+                if (EDGE_COLORS[j][0] == col0 && EDGE_COLORS[j][1] == col1) {
+                    result.ep[i] = static_cast<int8_t>(j);
+                    result.eo[i] = 0;
+                    break;
+                }
+                if (EDGE_COLORS[j][0] == col1 && EDGE_COLORS[j][1] == col0) {
+                    result.ep[i] = static_cast<int8_t>(j);
+                    result.eo[i] = 1;
+                    break;
+                }
+            }
+        }
+
+        return result.is_solvable();
+    }
+
+    void CubieCube::corner_multiply(const CubieCube& other) {
+        std::array<int8_t, N_CORNERS> new_cp;
+        std::array<int8_t, N_CORNERS> new_co;
+        for (int i = 0; i < N_CORNERS; ++i) {
+            new_cp[i] = cp[other.cp[i]];
+            new_co[i] = static_cast<int8_t>((co[other.cp[i]] + other.co[i]) % 3);
+        }
+        cp = new_cp;
+        co = new_co;
+    }
+
+    void CubieCube::edge_multiply(const CubieCube& other) {
+        std::array<int8_t, N_EDGES> new_ep;
+        std::array<int8_t, N_EDGES> new_eo;
+        for (int i = 0; i < N_EDGES; ++i) {
+            new_ep[i] = ep[other.ep[i]];
+            new_eo[i] = static_cast<int8_t>((eo[other.ep[i]] + other.eo[i]) % 2);
+        }
+        ep = new_ep;
+        eo = new_eo;
+    }
+
+    void CubieCube::multiply(const CubieCube& other) {
+        corner_multiply(other);
+        edge_multiply(other);
+    }
+
+    // Move m is face m / 3 turned (m % 3) + 1 quarter turns
+    void CubieCube::move(int m) {
+        const CubieCube& basic = basic_moves()[m / 3];
+        for (int k = 0; k <= m % 3; ++k) {
+            multiply(basic);
+        }
+    }
+
+    // The quarter turns are read off Cube's own move functions, so the
+    // cubie level and everything derived from it (the two-phase tables)
+    // follow the same move definitions as the genetic solver
+    const std::array<CubieCube, 6>& CubieCube::basic_moves() {
+        static const std::array<CubieCube, 6> moves = []() {
+            std::array<CubieCube, 6> result;
+            for (int f = 0; f < 6; ++f) {
+                Cube cube;
+                cube.execute({std::string(1, FACE_LETTERS[f])});
+                from_cube(cube, result[f]);
+            }
+            return result;
+        }();
+        return moves;
+    }
+
+    std::string CubieCube::move_name(int m) {
+        static const char* SUFFIXES[3] = {"", "2", "'"};
+        return std::string(1, FACE_LETTERS[m / 3]) + SUFFIXES[m % 3];
+    }
+
+// ---------------------------------------------------------------------------
+// Phase 1 coordinates
+// ---------------------------------------------------------------------------
+
+    int CubieCube::get_twist() const {
+        int twist = 0;
+        for (int i = 0; i < N_CORNERS - 1; ++i) {
+            twist = twist * 3 + co[i];
+        }
+        return twist;
+    }
+
+    void CubieCube::set_twist(int twist) {
+        int parity_sum = 0;
+        for (int i = N_CORNERS - 2; i >= 0; --i) {
+            co[i] = static_cast<int8_t>(twist % 3);
+            parity_sum += co[i];
+            twist /= 3;
+        }
+        co[N_CORNERS - 1] = static_cast<int8_t>((3 - parity_sum % 3) % 3);
+    }
+
+    int CubieCube::get_flip() const {
+        int flip = 0;
+        for (int i = 0; i < N_EDGES - 1; ++i) {
+            flip = flip * 2 + eo[i];
+        }
+        return flip;
+    }
+
+    void CubieCube::set_flip(int flip) {
+        int parity_sum = 0;
+        for (int i = N_EDGES - 2; i >= 0; --i) {
+            eo[i] = static_cast<int8_t>(flip % 2);
+            parity_sum += eo[i];
+            flip /= 2;
+        }
+        eo[N_EDGES - 1] = static_cast<int8_t>((2 - parity_sum % 2) % 2);
+    }
+
+    // Which 4 positions hold the UD-slice edges FR, FL, BL, BR (order ignored).
+    // 0 when they all sit in the slice.
+    int CubieCube::get_slice() const {
+        int slice = 0;
+        int found = 0;
+        for (int j = N_EDGES - 1; j >= 0; --j) {
+            if (ep[j] >= 8) {
+                slice += Cnk(N_EDGES - 1 - j, found + 1);
+                found++;
+            }
+        }
+        return slice;
+    }
+
+    void CubieCube::set_slice(int slice) {
+        int remaining = 4;
+        int next_slice = 8;
+        int next_other = 0;
+        for (int j = 0; j < N_EDGES; ++j) {
+            int c = Cnk(N_EDGES - 1 - j, remaining);
+            if (remaining > 0 && slice >= c) {
+                ep[j] = static_cast<int8_t>(next_slice++);
+                slice -= c;
+                remaining--;
+            } else {
+                ep[j] = static_cast<int8_t>(next_other++);
+            }
+            eo[j] = 0;
+        }
+    }
+
+// ---------------------------------------------------------------------------
+// Phase 2 coordinates
+// ---------------------------------------------------------------------------
+
+    int CubieCube::get_corner_perm() const {
+        return perm_to_index(cp, 0, N_CORNERS);
+    }
+
+    void CubieCube::set_corner_perm(int idx) {
+        index_to_perm(idx, cp, 0, N_CORNERS, 0);
+    }
+
+    int CubieCube::get_ud_edge_perm() const {
+        return perm_to_index(ep, 0, 8);
+    }
+
+    void CubieCube::set_ud_edge_perm(int idx) {
+        index_to_perm(idx, ep, 0, 8, 0);
+        for (int j = 8; j < N_EDGES; ++j) {
+            ep[j] = static_cast<int8_t>(j);
+        }
+    }
+
+    int CubieCube::get_slice_perm() const {
+        return perm_to_index(ep, 8, 4);
+    }
+
+    void CubieCube::set_slice_perm(int idx) {
+        for (int j = 0; j < 8; ++j) {
+            ep[j] = static_cast<int8_t>(j);
+        }
+        index_to_perm(idx, ep, 8, 4, 8);
+    }
+
+    bool CubieCube::is_solvable() const {
+        int corner_seen = 0;
+        int twist_sum = 0;
+        for (int i = 0; i < N_CORNERS; ++i) {
+            if (cp[i] < 0 || cp[i] >= N_CORNERS) {
+                return false;
+            }
+            corner_seen |= 1 << cp[i];
+            twist_sum += co[i];
+        }
+
+        int edge_seen = 0;
+        int flip_sum = 0;
+        for (int i = 0; i < N_EDGES; ++i) {
+            if (ep[i] < 0 || ep[i] >= N_EDGES) {
+                return false;
+            }
+            edge_seen |= 1 << ep[i];
+            flip_sum += eo[i];
+        }
+
+        return corner_seen == (1 << N_CORNERS) - 1 && edge_seen == (1 << N_EDGES) - 1
+            && twist_sum % 3 == 0 && flip_sum % 2 == 0 && parity(cp) == parity(ep);
+    }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Cube.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Cubie level representation of the cube used by the two-phase solver.
+// Corners and edges are numbered as in Kociemba's two-phase algorithm:
+//   corners: URF, UFL, ULB, UBR, DFR, DLF, DBL, DRB
+//   edges:   UR, UF, UL, UB, DR, DF, DL, DB, FR, FL, BL, BR
+// Each position holds the cubie sitting there and its orientation.
+class CubieCube {
+public:
+    static const int N_CORNERS = 8;
+    static const int N_EDGES = 12;
+
+    // Coordinate ranges
+    static const int N_TWIST = 2187;        // 3^7 corner orientations
+    static const int N_FLIP = 2048;         // 2^11 edge orientations
+    static const int N_SLICE = 495;         // C(12,4) positions of the UD-slice edges
+    static const int N_CORNER_PERM = 40320; // 8! corner permutations
+    static const int N_UD_EDGE_PERM = 40320;// 8! permutations of the U and D edges (phase 2)
+    static const int N_SLICE_PERM = 24;     // 4! permutations of the UD-slice edges (phase 2)
+
+    // The 18 face turns: U, R, F, D, L, B each as quarter, half and inverse turn
+    static const int N_MOVES = 18;
+
+    std::array<int8_t, N_CORNERS> cp;
+    std::array<int8_t, N_CORNERS> co;
+    std::array<int8_t, N_EDGES> ep;
+    std::array<int8_t, N_EDGES> eo;
+
+    CubieCube(); // solved cube
+
+    // Build the cubie representation of a facelet cube. Faces are identified
+    // by their center colour so slice moves and rotations are accounted for.
+    // Returns false if the stickers do not describe a solvable cube.
+    static bool from_cube(const Cube& cube, CubieCube& result);
+
+    // this = this * other, i.e. apply other on top of this
+    void corner_multiply(const CubieCube& other);
+    void edge_multiply(const CubieCube& other);
+    void multiply(const CubieCube& other);
+    void move(int m);
+
+    // Phase 1 coordinates
+    int get_twist() const;
+    void set_twist(int twist);
+    int get_flip() const;
+    void set_flip(int flip);
+    int get_slice() const;
+    void set_slice(int slice);
+
+    // Phase 2 coordinates
+    int get_corner_perm() const;
+    void set_corner_perm(int idx);
+    int get_ud_edge_perm() const;
+    void set_ud_edge_perm(int idx);
+    int get_slice_perm() const;
+    void set_slice_perm(int idx);
+
+    bool is_solvable() const;
+
+    static std::string move_name(int m);
+    static const std::array<CubieCube, 6>& basic_moves(); // quarter turns of U, R, F, D, L, B
+};
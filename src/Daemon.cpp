@@ -0,0 +1,587 @@
+#include "Daemon.h"
+#include "TwoPhaseSolver.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const size_t READ_CHUNK = 4096;
+const size_t MAX_REQUEST_BYTES = 64 * 1024;     // longest request line
+const size_t MAX_OUTGOING_BYTES = 1024 * 1024;  // unsent responses before a client stops being read
+const int MAX_PENDING_PER_WORKER = 4;           // jobs in flight per client, times the worker count
+const int SHUTDOWN_FLUSH_MS = 1000;
+
+static volatile std::sig_atomic_t stop_signal = 0;
+
+static void handle_stop_signal(int) {
+    stop_signal = 1;
+}
+
+// Writes all of data, returns false once the peer is gone
+static bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool make_address(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// A finite, non-negative number of seconds
+static bool parse_timeout(const std::string& value, double& out) {
+    char* end = nullptr;
+    double v = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !std::isfinite(v) || v < 0.0) {
+        return false;
+    }
+    out = v;
+    return true;
+}
+
+static bool parse_seed(const std::string& value, unsigned int& out) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    errno = 0;
+    unsigned long long v = std::strtoull(value.c_str(), nullptr, 10);
+    if (errno == ERANGE || v > std::numeric_limits<unsigned int>::max()) {
+        return false;
+    }
+    out = static_cast<unsigned int>(v);
+    return true;
+}
+
+// Removes a socket left behind by a daemon that did not shut down cleanly.
+// Fails if the path is anything else, or a daemon still accepts on it.
+static bool remove_stale_socket(const std::string& path, const sockaddr_un& addr) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) < 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        std::cerr << "Could not check " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        std::cerr << path << " exists and is not a socket" << std::endl;
+        return false;
+    }
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool live = probe >= 0 && connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+    if (probe >= 0) {
+        close(probe);
+    }
+    if (live) {
+        std::cerr << "A daemon is already listening on " << path << std::endl;
+        return false;
+    }
+    return unlink(path.c_str()) == 0 || errno == ENOENT;
+}
+
+static bool set_non_blocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static long long microseconds(std::chrono::steady_clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+// A client connection with a non-blocking socket. The dispatcher reads the
+// requests and writes out the responses workers append to outgoing; every
+// queued job holds a reference, so a response always has a buffer to go to.
+struct SolverDaemon::Connection {
+    int fd;
+    std::string buffer;     // dispatcher only: bytes after the last complete line
+    int requests = 0;       // dispatcher only
+    bool reading = true;    // dispatcher only: false once the client has finished sending
+
+    std::mutex write_mutex; // guards the members below
+    std::string outgoing;   // responses not yet written to the socket
+    int pending = 0;        // jobs queued or running
+    bool failed = false;    // the socket can no longer be written
+
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { close(fd); }
+
+    void queue_response(const std::string& line) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (!failed) {
+            outgoing += line;
+        }
+    }
+
+    void add_job() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        pending++;
+    }
+
+    void complete_job(const std::string& line) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (!failed) {
+            outgoing += line;
+        }
+        pending--;
+    }
+
+    // Writes as much of outgoing as the socket takes without blocking
+    void flush() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        size_t sent = 0;
+        while (sent < outgoing.size()) {
+            ssize_t n = send(fd, outgoing.data() + sent, outgoing.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (n <= 0) {
+                failed = true;
+                sent = outgoing.size();
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        outgoing.erase(0, sent);
+    }
+
+    // The dispatcher stops reading while a client has too much in flight
+    bool saturated(int max_pending) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return pending >= max_pending || outgoing.size() >= MAX_OUTGOING_BYTES;
+    }
+
+    bool has_output() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return !outgoing.empty() && !failed;
+    }
+
+    // Nothing left to read, answer or send
+    bool finished() {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        return failed || (!reading && pending == 0 && outgoing.empty());
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    SolverDaemon::SolverDaemon(const std::string& socket_path, const Config& config)
+        : socket_path(socket_path), config(config) {}
+
+    SolverDaemon::~SolverDaemon() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_ready.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    int SolverDaemon::run() {
+        sockaddr_un addr;
+        if (!make_address(socket_path, addr)) {
+            std::cerr << "Socket path too long: " << socket_path << std::endl;
+            return 1;
+        }
+        if (!remove_stale_socket(socket_path, addr)) {
+            return 1;
+        }
+        int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+            || listen(listen_fd, SOMAXCONN) < 0 || !set_non_blocking(listen_fd)) {
+            std::cerr << "Could not listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+            if (listen_fd >= 0) {
+                close(listen_fd);
+            }
+            return 1;
+        }
+        if (pipe(wake_fds) < 0 || !set_non_blocking(wake_fds[0]) || !set_non_blocking(wake_fds[1])) {
+            std::cerr << "Could not create the wake pipe: " << std::strerror(errno) << std::endl;
+            close(listen_fd);
+            unlink(socket_path.c_str());
+            return 1;
+        }
+
+        // Map the two-phase tables before the first request arrives
+        int n_workers = config.workers > 0 ? config.workers : std::max(1u, std::thread::hardware_concurrency());
+        int max_pending = MAX_PENDING_PER_WORKER * n_workers;
+        std::vector<std::unique_ptr<TwoPhaseSolver>> two_phase_solvers;
+        for (int i = 0; i < n_workers; ++i) {
+            two_phase_solvers.emplace_back(new TwoPhaseSolver());
+        }
+
+        // The stop signals stay blocked everywhere except inside the dispatcher's
+        // ppoll, which unblocks them atomically. A signal arriving while the
+        // dispatcher is busy stays pending until then instead of being missed.
+        sigset_t stop_signals, previous;
+        sigemptyset(&stop_signals);
+        sigaddset(&stop_signals, SIGINT);
+        sigaddset(&stop_signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &stop_signals, &previous);
+        sigset_t wait_mask = previous;
+        sigdelset(&wait_mask, SIGINT);
+        sigdelset(&wait_mask, SIGTERM);
+        for (int i = 0; i < n_workers; ++i) {
+            workers.emplace_back(&SolverDaemon::work, this, std::ref(*two_phase_solvers[i]));
+        }
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = handle_stop_signal;
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+
+        std::cout << "Listening on " << socket_path << " with " << n_workers << " workers" << std::endl;
+
+        // fds[0] is the listening socket, fds[1] the wake pipe, then one per connection
+        std::vector<std::shared_ptr<Connection>> connections;
+        while (!stop_signal) {
+            std::vector<pollfd> fds;
+            fds.push_back({listen_fd, POLLIN, 0});
+            fds.push_back({wake_fds[0], POLLIN, 0});
+            for (const auto& connection : connections) {
+                short events = 0;
+                if (connection->reading && !connection->saturated(max_pending)) {
+                    events |= POLLIN;
+                }
+                if (connection->has_output()) {
+                    events |= POLLOUT;
+                }
+                fds.push_back({connection->fd, events, 0});
+            }
+            if (ppoll(fds.data(), fds.size(), nullptr, &wait_mask) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::cerr << "ppoll failed: " << std::strerror(errno) << std::endl;
+                break;
+            }
+
+            if (fds[1].revents & POLLIN) {
+                char drain[READ_CHUNK];
+                while (read(wake_fds[0], drain, sizeof(drain)) > 0) {
+                }
+            }
+
+            // Everything read in this round is queued as one batch
+            std::vector<Job> batch;
+            for (size_t i = 2; i < fds.size(); ++i) {
+                std::shared_ptr<Connection>& connection = connections[i - 2];
+                if (fds[i].revents & POLLOUT) {
+                    connection->flush();
+                }
+                if (fds[i].revents & (POLLHUP | POLLERR)) {
+                    // The client is gone, responses still being solved go nowhere
+                    connection.reset();
+                    continue;
+                }
+                if (fds[i].revents & POLLIN) {
+                    read_requests(connection, batch);
+                }
+                if (connection->finished()) {
+                    connection.reset();
+                }
+            }
+            connections.erase(std::remove(connections.begin(), connections.end(), nullptr), connections.end());
+
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd, nullptr, nullptr);
+                if (fd >= 0 && set_non_blocking(fd)) {
+                    connections.push_back(std::make_shared<Connection>(fd));
+                } else if (fd >= 0) {
+                    close(fd);
+                }
+            }
+
+            submit(batch);
+        }
+
+        close(listen_fd);
+        unlink(socket_path.c_str());
+
+        // Running solves finish, queued ones are answered with an error
+        std::deque<Job> pending;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+            pending.swap(queue);
+        }
+        queue_ready.notify_all();
+        for (const auto& job : pending) {
+            job.connection->complete_job("id=" + job.id + " error=daemon shutting down\n");
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        flush_connections(connections);
+
+        close(wake_fds[0]);
+        close(wake_fds[1]);
+        wake_fds[0] = wake_fds[1] = -1;
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        std::cout << "Stopped" << std::endl;
+        return 0;
+    }
+
+    // Parses every complete line read from the connection into batch. A line
+    // too long to be a request ends the connection's input with an error.
+    void SolverDaemon::read_requests(const std::shared_ptr<Connection>& owner, std::vector<Job>& batch) {
+        Connection& connection = *owner;
+        char chunk[READ_CHUNK];
+        ssize_t n = read(connection.fd, chunk, sizeof(chunk));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        bool closed = n <= 0;
+        if (!closed) {
+            connection.buffer.append(chunk, static_cast<size_t>(n));
+        } else if (!connection.buffer.empty()) {
+            connection.buffer += '\n'; // last request without a newline
+        }
+
+        size_t start = 0;
+        size_t end;
+        while ((end = connection.buffer.find('\n', start)) != std::string::npos) {
+            std::string line = connection.buffer.substr(start, end - start);
+            start = end + 1;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            Job job;
+            std::string error;
+            if (parse_request(line, ++connection.requests, job, error)) {
+                job.connection = owner;
+                batch.push_back(std::move(job));
+                connection.add_job();
+            } else {
+                connection.queue_response("id=" + job.id + " error=" + error + "\n");
+            }
+        }
+        connection.buffer.erase(0, start);
+
+        if (connection.buffer.size() > MAX_REQUEST_BYTES) {
+            connection.queue_response("id=" + std::to_string(connection.requests + 1) + " error=request too long\n");
+            closed = true;
+        }
+        if (closed) {
+            connection.reading = false;
+            connection.buffer.clear();
+        }
+    }
+
+    // Gives the responses of the last solves up to SHUTDOWN_FLUSH_MS to reach their clients
+    void SolverDaemon::flush_connections(std::vector<std::shared_ptr<Connection>>& connections) {
+        Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(SHUTDOWN_FLUSH_MS);
+        for (;;) {
+            std::vector<pollfd> fds;
+            std::vector<Connection*> waiting;
+            for (const auto& connection : connections) {
+                connection->flush();
+                if (connection->has_output()) {
+                    fds.push_back({connection->fd, POLLOUT, 0});
+                    waiting.push_back(connection.get());
+                }
+            }
+            long long left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            if (fds.empty() || left <= 0) {
+                return;
+            }
+            if (poll(fds.data(), fds.size(), static_cast<int>(left)) < 0 && errno != EINTR) {
+                return;
+            }
+            for (size_t i = 0; i < fds.size(); ++i) {
+                if (fds[i].revents & (POLLHUP | POLLERR)) {
+                    std::lock_guard<std::mutex> lock(waiting[i]->write_mutex);
+                    waiting[i]->failed = true;
+                }
+            }
+        }
+    }
+
+    void SolverDaemon::submit(std::vector<Job>& batch) {
+        if (batch.empty()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            Clock::time_point now = Clock::now();
+            for (auto& job : batch) {
+                job.queued = now;
+                queue.push_back(std::move(job));
+            }
+        }
+        if (batch.size() == 1) {
+            queue_ready.notify_one();
+        } else {
+            queue_ready.notify_all();
+        }
+    }
+
+    void SolverDaemon::work(SolverBase& two_phase) {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_ready.wait(lock, [this]() { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            Clock::time_point started = Clock::now();
+            SolveResult result = run_job(job, two_phase);
+            Clock::time_point finished = Clock::now();
+
+            std::ostringstream response;
+            response << "id=" << job.id
+                     << " solved=" << result.solved
+                     << " cancelled=" << result.cancelled
+                     << " fitness=" << result.fitness
+                     << " moves=" << result.solution.size()
+                     << " queue_us=" << microseconds(started - job.queued)
+                     << " solve_us=" << microseconds(finished - started)
+                     << " solution=" << Cube::join(result.solution, " ") << "\n";
+            job.connection->complete_job(response.str());
+
+            // The dispatcher writes the response out once the socket takes it
+            char wake = 0;
+            ssize_t ignored = write(wake_fds[1], &wake, 1);
+            (void)ignored;
+        }
+    }
+
+    SolveResult SolverDaemon::run_job(const Job& job, SolverBase& two_phase) const {
+        CancellationToken token;
+        if (job.timeout > 0.0) {
+            token.set_timeout(job.timeout);
+        }
+        if (job.two_phase) {
+            return two_phase.solve(job.scramble, false, &token);
+        }
+        Solver genetic(config.genetic, job.has_seed ? job.seed : std::random_device{}());
+        return genetic.solve(job.scramble, false, &token);
+    }
+
+// ---------------------------------------------------------------------------
+// Utilities
+// ---------------------------------------------------------------------------
+
+    bool SolverDaemon::parse_request(const std::string& line, int sequence, Job& job, std::string& error) const {
+        job.id = std::to_string(sequence);
+        job.timeout = config.timeout;
+
+        std::istringstream in(line);
+        std::string token;
+        while (in >> token) {
+            size_t eq = token.find('=');
+            if (eq == std::string::npos) {
+                Move move;
+                if (!parse_move(token.c_str(), token.size(), move)) {
+                    error = "invalid move " + token;
+                    return false;
+                }
+                job.scramble.push_back(token);
+                continue;
+            }
+
+            std::string key = token.substr(0, eq);
+            std::string value = token.substr(eq + 1);
+            if (key == "id") {
+                job.id = value;
+            } else if (key == "solver" && (value == "ga" || value == "two-phase")) {
+                job.two_phase = value == "two-phase";
+            } else if (key == "timeout" && parse_timeout(value, job.timeout)) {
+                continue;
+            } else if (key == "seed" && parse_seed(value, job.seed)) {
+                job.has_seed = true;
+            } else {
+                error = "invalid option " + token;
+                return false;
+            }
+        }
+        return true;
+    }
+
+// ---------------------------------------------------------------------------
+// Client
+// ---------------------------------------------------------------------------
+
+    int run_client(const std::string& socket_path, std::istream& in, std::ostream& out) {
+        sockaddr_un addr;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (!make_address(socket_path, addr) || fd < 0
+            || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::cerr << "Could not connect to " << socket_path << std::endl;
+            if (fd >= 0) {
+                close(fd);
+            }
+            return 1;
+        }
+
+        // Requests are sent from their own thread so responses stream back meanwhile
+        std::thread sender([&]() {
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.find_first_not_of(" \t\r") != std::string::npos && !send_all(fd, line + "\n")) {
+                    break;
+                }
+            }
+            shutdown(fd, SHUT_WR);
+        });
+
+        // The daemon closes the connection after the last response
+        char chunk[READ_CHUNK];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            out.write(chunk, n);
+            out.flush();
+        }
+
+        sender.join();
+        close(fd);
+        return 0;
+    }
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Solver.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Long running solver service on a Unix domain socket.
+//
+// Protocol: one request per line, one response per line. A request is a
+// scramble, optionally preceded by key=value options:
+//
+//     id=7 solver=two-phase timeout=2 R U2 F' D L2 B
+//
+//     id       echoed in the response, defaults to the request's position on the connection
+//     solver   ga (default) or two-phase
+//     timeout  seconds, defaults to the daemon's timeout, 0 for none
+//     seed     seed of a genetic solve, 0 to 4294967295
+//
+// An option with an invalid value is answered with an error like any
+// unknown option.
+//
+// Responses are streamed back as solves finish, so they may arrive out of
+// order; the solution takes the rest of the line:
+//
+//     id=7 solved=1 cancelled=0 fitness=0 moves=21 queue_us=35 solve_us=4102 solution=R U ...
+//     id=8 error=invalid move Q
+//
+// The dispatcher thread polls all connections and queues every request
+// read in one round as a single batch. A fixed pool of workers takes jobs
+// from the queue; each keeps a TwoPhaseSolver whose tables are mapped once
+// for the whole process, so a request pays neither startup nor table load.
+//
+// Sockets are non-blocking and only the dispatcher writes to them: a worker
+// appends its response to the connection's outgoing buffer and wakes the
+// dispatcher through a pipe. A client that does not read its responses
+// therefore stalls nobody else. It is no longer read from while it has
+// 4 jobs per worker in flight or 1 MB of unsent responses, and a request
+// line over 64 KB ends its input with an error.
+class SolverDaemon {
+public:
+    struct Config {
+        int workers = 0;            // 0 uses every core
+        double timeout = 0.0;       // default per request timeout, 0 for none
+        SolverConfig genetic;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection;
+
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        std::string id;
+        bool two_phase = false;
+        double timeout = 0.0;
+        bool has_seed = false;
+        unsigned int seed = 0;
+        std::vector<std::string> scramble;
+        Clock::time_point queued;
+    };
+
+    std::string socket_path;
+    Config config;
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::deque<Job> queue;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+    int wake_fds[2] = {-1, -1};  // workers write a byte to wake the dispatcher for their response
+
+    bool parse_request(const std::string& line, int sequence, Job& job, std::string& error) const;
+    void read_requests(const std::shared_ptr<Connection>& connection, std::vector<Job>& batch);
+    void flush_connections(std::vector<std::shared_ptr<Connection>>& connections);
+    void submit(std::vector<Job>& batch);
+    void work(SolverBase& two_phase);
+    SolveResult run_job(const Job& job, SolverBase& two_phase) const;
+
+public:
+    SolverDaemon(const std::string& socket_path, const Config& config);
+    ~SolverDaemon();
+
+    // Serves requests until SIGINT or SIGTERM. Returns the process exit code.
+    int run();
+};
+
+// Sends each non-empty line of in as a request and copies the responses to
+// out, waiting until all of them have arrived. Returns the process exit code.
+int run_client(const std::string& socket_path, std::istream& in, std::ostream& out);
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Move definitions as compile-time data. Every move is a permutation of the
+// 54 stickers, numbered face * 9 + row * 3 + column with the faces in the
+// order below. A move is applied as new[i] = old[perm[i]].
+//
+// From these tables Kernel<> generates, per move or per fixed sequence of
+// moves, a straight-line function that moves exactly the stickers the
+// permutation touches, with every index known at compile time.
+
+const int N_STICKERS = 54;
+
+using Stickers = std::array<char, N_STICKERS>;
+using Perm = std::array<uint8_t, N_STICKERS>;
+
+enum class Face : uint8_t { TOP, RIGHT, FRONT, BOTTOM, LEFT, BACK };
+
+// Each layer or rotation comes as quarter turn, inverse and half turn, in
+// the order of MOVE_LETTERS
+enum class Move : uint8_t {
+    U, U_PRIME, U2, D, D_PRIME, D2, E, E_PRIME, E2,
+    L, L_PRIME, L2, M, M_PRIME, M2, R, R_PRIME, R2,
+    F, F_PRIME, F2, B, B_PRIME, B2, S, S_PRIME, S2,
+    X, X_PRIME, X2, Y, Y_PRIME, Y2, Z, Z_PRIME, Z2
+};
+
+const int N_CUBE_MOVES = 36;
+
+constexpr const char MOVE_LETTERS[] = "UDELMRFBSxyz";
+
+constexpr const char* MOVE_NAMES[N_CUBE_MOVES] = {
+    "U", "U'", "U2", "D", "D'", "D2", "E", "E'", "E2",
+    "L", "L'", "L2", "M", "M'", "M2", "R", "R'", "R2",
+    "F", "F'", "F2", "B", "B'", "B2", "S", "S'", "S2",
+    "x", "x'", "x2", "y", "y'", "y2", "z", "z'", "z2"
+};
+
+// Parses a move name such as "R", "R'" or "R2"; returns false if unknown
+constexpr bool parse_move(const char* name, size_t length, Move& move) {
+    if (length < 1 || length > 2) {
+        return false;
+    }
+    int letter = -1;
+    for (int i = 0; MOVE_LETTERS[i] != '\0'; ++i) {
+        if (MOVE_LETTERS[i] == name[0]) {
+            letter = i;
+        }
+    }
+    if (letter < 0) {
+        return false;
+    }
+    int variant = 0;
+    if (length == 2) {
+        if (name[1] == '\'') {
+            variant = 1;
+        } else if (name[1] == '2') {
+            variant = 2;
+        } else {
+            return false;
+        }
+    }
+    move = static_cast<Move>(letter * 3 + variant);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Quarter turn definitions
+// ---------------------------------------------------------------------------
+
+// Three stickers of a face, in the order they travel together
+using Strip = std::array<uint8_t, 3>;
+
+constexpr Strip row(Face face, int r) {
+    int base = static_cast<int>(face) * 9 + r * 3;
+    return {static_cast<uint8_t>(base), static_cast<uint8_t>(base + 1), static_cast<uint8_t>(base + 2)};
+}
+
+constexpr Strip col(Face face, int c) {
+    int base = static_cast<int>(face) * 9 + c;
+    return {static_cast<uint8_t>(base), static_cast<uint8_t>(base + 3), static_cast<uint8_t>(base + 6)};
+}
+
+constexpr Strip rev(Strip strip) {
+    return {strip[2], strip[1], strip[0]};
+}
+
+// A quarter turn rotates its face clockwise (slices have none) and cycles
+// four strips, cycle[k] receiving the stickers of cycle[k + 1]
+struct QuarterTurn {
+    bool turns_face;
+    Face face;
+    std::array<Strip, 4> cycle;
+};
+
+constexpr std::array<QuarterTurn, 9> QUARTER_TURNS = {{
+    // X Axis movements - U, D and E
+    {true, Face::TOP, {row(Face::RIGHT, 0), row(Face::BACK, 0), row(Face::LEFT, 0), row(Face::FRONT, 0)}},
+    {true, Face::BOTTOM, {row(Face::RIGHT, 2), row(Face::FRONT, 2), row(Face::LEFT, 2), row(Face::BACK, 2)}},
+    {false, Face::TOP, {row(Face::RIGHT, 1), row(Face::FRONT, 1), row(Face::LEFT, 1), row(Face::BACK, 1)}},
+
+    // Y Axis movements - L, M and R
+    {true, Face::LEFT, {col(Face::TOP, 0), rev(col(Face::BACK, 2)), col(Face::BOTTOM, 0), col(Face::FRONT, 0)}},
+    {false, Face::TOP, {col(Face::TOP, 1), rev(col(Face::BACK, 1)), col(Face::BOTTOM, 1), col(Face::FRONT, 1)}},
+    {true, Face::RIGHT, {col(Face::TOP, 2), col(Face::FRONT, 2), col(Face::BOTTOM, 2), rev(col(Face::BACK, 0))}},
+
+    // Z Axis movements - F, B and S
+    {true, Face::FRONT, {row(Face::TOP, 2), rev(col(Face::LEFT, 2)), rev(row(Face::BOTTOM, 0)), col(Face::RIGHT, 0)}},
+    {true, Face::BACK, {row(Face::TOP, 0), col(Face::RIGHT, 2), rev(row(Face::BOTTOM, 2)), rev(col(Face::LEFT, 0))}},
+    {false, Face::TOP, {row(Face::TOP, 1), rev(col(Face::LEFT, 1)), rev(row(Face::BOTTOM, 1)), col(Face::RIGHT, 1)}}
+}};
+
+// ---------------------------------------------------------------------------
+// Permutation algebra
+// ---------------------------------------------------------------------------
+
+constexpr Perm identity_perm() {
+    Perm p = {};
+    for (int i = 0; i < N_STICKERS; ++i) {
+        p[i] = static_cast<uint8_t>(i);
+    }
+    return p;
+}
+
+constexpr Perm quarter_turn_perm(const QuarterTurn& q) {
+    Perm p = identity_perm();
+    if (q.turns_face) {
+        int base = static_cast<int>(q.face) * 9;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                p[base + j * 3 + (2 - i)] = static_cast<uint8_t>(base + i * 3 + j);
+            }
+        }
+    }
+    for (int k = 0; k < 4; ++k) {
+        for (int t = 0; t < 3; ++t) {
+            p[q.cycle[k][t]] = q.cycle[(k + 1) % 4][t];
+        }
+    }
+    return p;
+}
+
+// Permutation of applying a and then b
+constexpr Perm compose(const Perm& a, const Perm& b) {
+    Perm p = {};
+    for (int i = 0; i < N_STICKERS; ++i) {
+        p[i] = a[b[i]];
+    }
+    return p;
+}
+
+constexpr Perm power(const Perm& p, int n) {
+    Perm result = identity_perm();
+    for (int i = 0; i < n; ++i) {
+        result = compose(result, p);
+    }
+    return result;
+}
+
+constexpr std::array<Perm, N_CUBE_MOVES> make_move_perms() {
+    std::array<Perm, N_CUBE_MOVES> perms = {};
+    auto add = [&perms](int first, const Perm& quarter) {
+        perms[first] = quarter;
+        perms[first + 1] = power(quarter, 3);
+        perms[first + 2] = power(quarter, 2);
+    };
+    for (int i = 0; i < 9; ++i) {
+        add(i * 3, quarter_turn_perm(QUARTER_TURNS[i]));
+    }
+
+    // Full rotations turn all three layers of an axis
+    auto p = [&perms](Move m) { return perms[static_cast<int>(m)]; };
+    add(static_cast<int>(Move::X), compose(compose(p(Move::L_PRIME), p(Move::M_PRIME)), p(Move::R)));
+    add(static_cast<int>(Move::Y), compose(compose(p(Move::U), p(Move::E_PRIME)), p(Move::D_PRIME)));
+    add(static_cast<int>(Move::Z), compose(compose(p(Move::F), p(Move::S)), p(Move::B_PRIME)));
+    return perms;
+}
+
+constexpr std::array<Perm, N_CUBE_MOVES> MOVE_PERMS = make_move_perms();
+
+// ---------------------------------------------------------------------------
+// Move sequences
+// ---------------------------------------------------------------------------
+
+const int MAX_SEQUENCE_LENGTH = 24;
+
+struct MoveSequence {
+    int length = 0;
+    std::array<Move, MAX_SEQUENCE_LENGTH> moves = {};
+};
+
+// Parses a space separated sequence such as "R U R' U'". Used in a constant
+// expression a malformed sequence is a compile error.
+constexpr MoveSequence sequence(const char* text) {
+    MoveSequence seq;
+    size_t i = 0;
+    while (text[i] != '\0') {
+        while (text[i] == ' ') {
+            ++i;
+        }
+        size_t start = i;
+        while (text[i] != ' ' && text[i] != '\0') {
+            ++i;
+        }
+        if (i == start) {
+            break;
+        }
+        Move m = Move::U;
+        if (!parse_move(text + start, i - start, m) || seq.length == MAX_SEQUENCE_LENGTH) {
+            throw "invalid move sequence";
+        }
+        seq.moves[seq.length++] = m;
+    }
+    return seq;
+}
+
+constexpr Perm sequence_perm(const MoveSequence& seq) {
+    Perm p = identity_perm();
+    for (int i = 0; i < seq.length; ++i) {
+        p = compose(p, MOVE_PERMS[static_cast<int>(seq.moves[i])]);
+    }
+    return p;
+}
+
+// ---------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------
+
+// Stickers a permutation actually moves, as (destination, source) pairs
+template <size_t N>
+struct Gather {
+    std::array<uint8_t, N> destination;
+    std::array<uint8_t, N> source;
+};
+
+constexpr size_t moved_stickers(const Perm& p) {
+    size_t n = 0;
+    for (int i = 0; i < N_STICKERS; ++i) {
+        if (p[i] != i) {
+            n++;
+        }
+    }
+    return n;
+}
+
+template <size_t N>
+constexpr Gather<N> make_gather(const Perm& p) {
+    Gather<N> g = {};
+    size_t k = 0;
+    for (int i = 0; i < N_STICKERS; ++i) {
+        if (p[i] != i) {
+            g.destination[k] = static_cast<uint8_t>(i);
+            g.source[k] = p[i];
+            k++;
+        }
+    }
+    return g;
+}
+
+// Source provides `static constexpr Perm perm()`
+template <typename Source>
+struct Kernel {
+    static constexpr Perm PERM = Source::perm();
+    static constexpr size_t N = moved_stickers(PERM);
+    static constexpr Gather<N> GATHER = make_gather<N>(PERM);
+
+    template <size_t... I>
+    static void run(Stickers& s, std::index_sequence<I...>) {
+        const Stickers old = s;
+        ((s[GATHER.destination[I]] = old[GATHER.source[I]]), ...);
+    }
+
+    static void apply(Stickers& s) {
+        run(s, std::make_index_sequence<N>{});
+    }
+};
+
+template <Move M>
+struct MovePerm {
+    static constexpr Perm perm() { return MOVE_PERMS[static_cast<int>(M)]; }
+};
+
+template <Move M>
+using MoveKernel = Kernel<MovePerm<M>>;
@@ -0,0 +1,177 @@
+#include "ProgressLog.h"
+#include <chrono>
+#include <iostream>
+
+// How long the writer sleeps when the queue is empty, flush() wakes it early
+const std::chrono::milliseconds WRITER_IDLE(10);
+
+// ---------------------------------------------------------------------------
+// Sinks
+// ---------------------------------------------------------------------------
+
+    TextSink::TextSink(std::ostream& out) : out(out) {}
+
+    TextSink::TextSink(std::unique_ptr<std::ostream> out) : out(*out), owned(std::move(out)) {}
+
+    void TextSink::write(const ProgressRecord& record) {
+        using Kind = ProgressRecord::Kind;
+        if (record.source != 0) {
+            out << "[" << record.source << "] ";
+        }
+        switch (record.kind) {
+            case Kind::STARTED:
+                out << "Starting...\n";
+                break;
+            case Kind::RESUMED:
+                out << "Resuming from world " << record.world << " generation " << record.generation << "\n";
+                break;
+            case Kind::RESUME_FAILED:
+                out << "Could not resume from checkpoint\n";
+                break;
+            case Kind::GENERATION:
+                if (last_world != record.world) { // Only print when the world changes
+                    out << "World: " << record.world << "\n";
+                    last_world = record.world;
+                }
+                out << "\tGeneration: " << record.generation
+                    << "\tIncorrect stickers: " << record.best_fitness
+                    << "\tMutation rate: " << record.mutation_rate
+                    << "\tDiversity: " << record.diversity << "\n";
+                break;
+            case Kind::STAGNATED:
+                out << "No improvement for " << record.value << " generations\n";
+                break;
+            case Kind::RESET:
+                out << "------------------------------------\n";
+                out << "Resetting the world\n";
+                break;
+            case Kind::CANCELLED:
+                out << "Deadline reached\n";
+                break;
+            case Kind::CHECKPOINT_FAILED:
+                out << "Could not write checkpoint\n";
+                break;
+            case Kind::DROPPED:
+                out << "Dropped " << record.value << " progress records, the log is incomplete\n";
+                break;
+        }
+    }
+
+    void TextSink::flush() {
+        out.flush();
+    }
+
+    JsonlSink::JsonlSink(std::ostream& out) : out(out) {}
+
+    JsonlSink::JsonlSink(std::unique_ptr<std::ostream> out) : out(*out), owned(std::move(out)) {}
+
+    void JsonlSink::write(const ProgressRecord& record) {
+        static const char* KIND_NAMES[] = {"started", "resumed", "resume_failed", "generation",
+                                           "stagnated", "reset", "cancelled", "checkpoint_failed", "dropped"};
+        out << "{\"event\":\"" << KIND_NAMES[static_cast<int>(record.kind)] << "\""
+            << ",\"source\":" << record.source
+            << ",\"world\":" << record.world
+            << ",\"generation\":" << record.generation
+            << ",\"best_fitness\":" << record.best_fitness
+            << ",\"diversity\":" << record.diversity
+            << ",\"mutation_rate\":" << record.mutation_rate
+            << ",\"value\":" << record.value
+            << ",\"elapsed_us\":" << record.elapsed_us << "}\n";
+    }
+
+    void JsonlSink::flush() {
+        out.flush();
+    }
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    ProgressLog::ProgressLog(std::unique_ptr<LogSink> sink, size_t capacity)
+        : sink(std::move(sink)), queue(capacity) {
+        writer = std::thread(&ProgressLog::run, this);
+    }
+
+    ProgressLog::~ProgressLog() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    bool ProgressLog::log(const ProgressRecord& record) {
+        if (!queue.push(record)) {
+            dropped_records.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pushed.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    void ProgressLog::flush() {
+        uint64_t target = pushed.load(std::memory_order_acquire);
+        uint64_t target_drops = dropped_records.load(std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake_requested = true;
+        wake.notify_one();
+        drained.wait(lock, [&]() {
+            return written.load(std::memory_order_acquire) >= target
+                && reported_drops.load(std::memory_order_relaxed) >= target_drops;
+        });
+    }
+
+    uint64_t ProgressLog::dropped() const {
+        return dropped_records.load(std::memory_order_relaxed);
+    }
+
+    ProgressLog& ProgressLog::console() {
+        static ProgressLog log(std::unique_ptr<LogSink>(new TextSink(std::cout)));
+        return log;
+    }
+
+    // Writes everything queued, then a DROPPED record if records were lost
+    // since the last one, and flushes the sink once for the whole batch
+    size_t ProgressLog::drain() {
+        size_t n = 0;
+        ProgressRecord record;
+        while (queue.pop(record)) {
+            sink->write(record);
+            n++;
+        }
+        uint64_t drops = dropped_records.load(std::memory_order_relaxed);
+        uint64_t reported = reported_drops.load(std::memory_order_relaxed);
+        if (drops > reported) {
+            ProgressRecord lost;
+            lost.kind = ProgressRecord::Kind::DROPPED;
+            lost.value = static_cast<int>(drops - reported);
+            sink->write(lost);
+        }
+        if (n > 0 || drops > reported) {
+            sink->flush();
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                written.fetch_add(n, std::memory_order_release);
+                reported_drops.store(drops, std::memory_order_relaxed);
+            }
+            drained.notify_all();
+        }
+        return n;
+    }
+
+    // Producers never touch the mutex, only flush() and the destructor do
+    void ProgressLog::run() {
+        for (;;) {
+            if (drain() > 0) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait_for(lock, WRITER_IDLE, [this]() { return stopping || wake_requested; });
+            wake_requested = false;
+            if (stopping) {
+                break;
+            }
+        }
+        drain();
+    }
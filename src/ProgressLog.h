@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+// One progress event of a genetic solve. Records are plain values so that
+// enqueueing one never allocates.
+struct ProgressRecord {
+    enum class Kind : uint8_t {
+        STARTED,            // solve started
+        RESUMED,            // continued from a checkpoint at world/generation
+        RESUME_FAILED,      // checkpoint did not match, starting over
+        GENERATION,         // best of a generation, after sorting
+        STAGNATED,          // world reset early, value = generations without improvement
+        RESET,              // world finished without a solution
+        CANCELLED,          // token cancelled or deadline passed
+        CHECKPOINT_FAILED,  // checkpoint could not be written
+        DROPPED             // written by the log itself, value = records lost to a full queue since the last one
+    };
+
+    Kind kind = Kind::GENERATION;
+    int source = 0;         // solve that produced the record, 0 when there is only one
+    int world = 0;          // one based, as printed
+    int generation = 0;
+    int best_fitness = -1;  // incorrect stickers of the best cube
+    int value = 0;
+    double diversity = 0.0; // distinct sticker states / population size
+    double mutation_rate = 0.0;
+    int64_t elapsed_us = 0; // since the solve started, including time before a resume
+};
+
+// Destination of the records, only ever called from the writer thread
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const ProgressRecord& record) = 0;
+    virtual void flush() = 0;
+};
+
+// Human readable lines, the format verbose solves have always printed
+class TextSink : public LogSink {
+private:
+    std::ostream& out;
+    std::unique_ptr<std::ostream> owned;
+    int last_world = -1;
+
+public:
+    explicit TextSink(std::ostream& out);
+    explicit TextSink(std::unique_ptr<std::ostream> out);
+
+    void write(const ProgressRecord& record) override;
+    void flush() override;
+};
+
+// One JSON object per line, for feeding runs into analysis scripts
+class JsonlSink : public LogSink {
+private:
+    std::ostream& out;
+    std::unique_ptr<std::ostream> owned;
+
+public:
+    explicit JsonlSink(std::ostream& out);
+    explicit JsonlSink(std::unique_ptr<std::ostream> out);
+
+    void write(const ProgressRecord& record) override;
+    void flush() override;
+};
+
+// Bounded lock-free queue for many producers and a single consumer. Each cell
+// carries a sequence number telling whose turn it is: producers claim a slot
+// with one compare-exchange on the tail, the consumer owns the head.
+template <typename T>
+class MpscQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) size_t head = 0;
+
+public:
+    // capacity is rounded up to a power of two
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false if the queue is full
+    bool push(const T& value) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only. Returns false if the queue is empty.
+    bool pop(T& value) {
+        Cell& cell = cells[head & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(head + 1) < 0) {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        head++;
+        return true;
+    }
+};
+
+// Asynchronous progress log. Solvers only enqueue records; a background
+// thread polls the queue every few milliseconds, writes what it finds to the
+// sink and flushes it once per batch rather than once per line. If the queue
+// is full the record is dropped and counted, logging never blocks a solver;
+// the writer then adds a DROPPED record so a truncated log says so.
+class ProgressLog {
+private:
+    std::unique_ptr<LogSink> sink;
+    MpscQueue<ProgressRecord> queue;
+    std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped_records{0};
+    std::atomic<uint64_t> reported_drops{0};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;  // signalled by the writer after each batch
+    bool stopping = false;
+    bool wake_requested = false;
+    std::thread writer;
+
+    void run();
+    size_t drain();
+
+public:
+    explicit ProgressLog(std::unique_ptr<LogSink> sink, size_t capacity = 4096);
+    ~ProgressLog();
+
+    ProgressLog(const ProgressLog&) = delete;
+    ProgressLog& operator=(const ProgressLog&) = delete;
+
+    bool log(const ProgressRecord& record);
+    // Waits until every record logged so far, and every drop so far, has been written and flushed
+    void flush();
+    // Records lost to a full queue since the log was created
+    uint64_t dropped() const;
+
+    // Text sink on std::cout, used by verbose solves without a log of their own
+    static ProgressLog& console();
+};
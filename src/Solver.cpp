@@ -0,0 +1,530 @@
+#include "Solver.h"
+#include "Checkpoint.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+const std::array<Move, 18> SINGLE_MOVES = {Move::U, Move::U_PRIME, Move::U2, Move::D, Move::D_PRIME, Move::D2,
+                                         Move::R, Move::R_PRIME, Move::R2, Move::L, Move::L_PRIME, Move::L2,
+                                         Move::F, Move::F_PRIME, Move::F2, Move::B, Move::B_PRIME, Move::B2};
+
+const std::array<Move, 6> FULL_ROTATIONS = {Move::X, Move::X_PRIME, Move::X2, Move::Y, Move::Y_PRIME, Move::Y2};
+
+const std::array<Move, 3> ORIENTATIONS = {Move::Z, Move::Z_PRIME, Move::Z2};
+
+// Parsed at compile time, each permutation is applied by a single kernel
+constexpr std::array<MoveSequence, 15> PERMUTATIONS = {{
+
+    // Permutes two edges: U face, bottom edge and right edge
+    sequence("F' L' B' R' U' R U' B L F R U R' U"),
+
+    // Permutes two edges: U face, bottom edge and left edge
+    sequence("F R B L U L' U B' R' F' L' U' L U'"),
+
+    // Permutes two corners: U face, bottom left and bottom right
+    sequence("U2 B U2 B' R2 F R' F' U2 F' U2 F R'"),
+
+    // Permutes three corners: U face, bottom left and top left
+    sequence("U2 R U2 R' F2 L F' L' U2 L' U2 L F'"),
+
+    // Permutes three centers: F face, top, right, bottom
+    sequence("U' B2 D2 L' F2 D2 B2 R' U'"),
+
+    // Permutes three centers: F face, top, right, left
+    sequence("U B2 D2 R F2 D2 B2 L U"),
+
+    // U face: bottom edge <-> right edge, bottom right corner <-> top right corner
+    sequence("D' R' D R2 U' R B2 L U' L' B2 U R2"),
+
+    // U face: bottom edge <-> right edge, bottom right corner <-> left right corner
+    sequence("D L D' L2 U L' B2 R' U R B2 U' L2"),
+
+    // U face: top edge <-> bottom edge, bottom left corner <-> top right corner
+    sequence("R' U L' U2 R U' L R' U L' U2 R U' L U'"),
+
+    // U face: top edge <-> bottom edge, bottom right corner <-> top left corner
+    sequence("L U' R U2 L' U R' L U' R U2 L' U R' U"),
+
+    // Permutes three corners: U face, bottom right, bottom left and top left
+    sequence("F' U B U' F U B' U'"),
+
+    // Permutes three corners: U face, bottom left, bottom right and top right
+    sequence("F U' B' U F' U' B U"),
+
+    // Permutes three edges: F face bottom, F face top, B face top
+    sequence("L' U2 L R' F2 R"),
+
+    // Permutes three edges: F face top, B face top, B face bottom
+    sequence("R' U2 R L' B2 L"),
+
+    // H permutation: U Face, swaps the edges horizontally and vertically
+    sequence("M2 U M2 U2 M2 U M2")
+}};
+
+const int N_PERMUTATIONS = static_cast<int>(PERMUTATIONS.size());
+
+template <int K>
+struct PermutationPerm {
+    static constexpr Perm perm() { return sequence_perm(PERMUTATIONS[K]); }
+};
+
+// Move names of each permutation for the move history
+static std::vector<std::vector<std::string>> permutation_names() {
+    std::vector<std::vector<std::string>> names;
+    for (const auto& seq : PERMUTATIONS) {
+        std::vector<std::string> moves;
+        for (int i = 0; i < seq.length; ++i) {
+            moves.push_back(MOVE_NAMES[static_cast<int>(seq.moves[i])]);
+        }
+        names.push_back(moves);
+    }
+    return names;
+}
+
+const std::vector<std::vector<std::string>> PERMUTATION_NAMES = permutation_names();
+
+// Runtime dispatch onto the kernel of permutation k
+static void apply_permutation(Stickers& stickers, int k) {
+    switch (k) {
+        case 0:  Kernel<PermutationPerm<0>>::apply(stickers); break;
+        case 1:  Kernel<PermutationPerm<1>>::apply(stickers); break;
+        case 2:  Kernel<PermutationPerm<2>>::apply(stickers); break;
+        case 3:  Kernel<PermutationPerm<3>>::apply(stickers); break;
+        case 4:  Kernel<PermutationPerm<4>>::apply(stickers); break;
+        case 5:  Kernel<PermutationPerm<5>>::apply(stickers); break;
+        case 6:  Kernel<PermutationPerm<6>>::apply(stickers); break;
+        case 7:  Kernel<PermutationPerm<7>>::apply(stickers); break;
+        case 8:  Kernel<PermutationPerm<8>>::apply(stickers); break;
+        case 9:  Kernel<PermutationPerm<9>>::apply(stickers); break;
+        case 10: Kernel<PermutationPerm<10>>::apply(stickers); break;
+        case 11: Kernel<PermutationPerm<11>>::apply(stickers); break;
+        case 12: Kernel<PermutationPerm<12>>::apply(stickers); break;
+        case 13: Kernel<PermutationPerm<13>>::apply(stickers); break;
+        case 14: Kernel<PermutationPerm<14>>::apply(stickers); break;
+        default: break;
+    }
+}
+static_assert(PERMUTATIONS.size() == 15, "apply_permutation needs a case per permutation");
+
+// Distinct sticker states over population size, 1 when every cube differs
+static double population_diversity(const std::vector<Cube>& cubes) {
+    std::vector<uint64_t> hashes;
+    hashes.reserve(cubes.size());
+    for (const auto& cube : cubes) {
+        uint64_t h = 14695981039346656037ULL; // FNV-1a
+        for (char c : cube.stickers) {
+            h = (h ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+        }
+        hashes.push_back(h);
+    }
+    std::sort(hashes.begin(), hashes.end());
+    size_t distinct = std::unique(hashes.begin(), hashes.end()) - hashes.begin();
+    return cubes.empty() ? 0.0 : static_cast<double>(distinct) / cubes.size();
+}
+
+// Adaptive mutation
+const double MAX_EXTRA_MUTATION_RATE = 0.5; // chance of a second evolution step once a world plateaus
+const double WEIGHT_ADAPTATION = 0.1;   // how fast operator weights follow their success rate
+const double MIN_EVOLUTION_WEIGHT = 0.01;
+
+// ---------------------------------------------------------------------------
+// Utilities
+// ---------------------------------------------------------------------------
+
+    Cube Solver::copyCube(const Cube& cube_from) {
+        Cube cube_to;
+        cube_to.stickers = cube_from.stickers;
+        cube_to.move_history = cube_from.move_history;
+        cube_to.fitness = cube_from.fitness;
+        return cube_to;
+    }
+
+    int Solver::rnd(int n) {
+        return static_cast<int>(rng() % n);
+    }
+
+    // Uniform in [0, 1)
+    double Solver::rnd_unit() {
+        return rng() / (static_cast<double>(rng.max()) + 1.0);
+    }
+
+    Move Solver::rnd_single_move() {
+        return SINGLE_MOVES[rnd(SINGLE_MOVES.size())];
+    }
+
+    int Solver::rnd_permutation() {
+        return rnd(N_PERMUTATIONS);
+    }
+
+    Move Solver::rnd_full_rotation() {
+        return FULL_ROTATIONS[rnd(FULL_ROTATIONS.size())];
+    }
+
+    Move Solver::rnd_orientation() {
+        return ORIENTATIONS[rnd(ORIENTATIONS.size())];
+    }
+
+    void Solver::execute_permutation(Cube& cube, int k) {
+        apply_permutation(cube.stickers, k);
+        cube.record(PERMUTATION_NAMES[k]);
+    }
+
+    // Roulette wheel selection over the adaptive evolution weights
+    int Solver::rnd_evolution_type() {
+        double total = 0.0;
+        for (double w : evolution_weights) {
+            total += w;
+        }
+        double r = total * rnd_unit();
+        for (int t = 0; t < N_EVOLUTION_TYPES; ++t) {
+            r -= evolution_weights[t];
+            if (r < 0.0) {
+                return t;
+            }
+        }
+        return N_EVOLUTION_TYPES - 1;
+    }
+
+    void Solver::evolve(Cube& cube, int evolution_type) {
+        switch (evolution_type) {
+            case 0:
+                execute_permutation(cube, rnd_permutation());
+                break;
+            case 1:
+                execute_permutation(cube, rnd_permutation());
+                execute_permutation(cube, rnd_permutation());
+                break;
+            case 2:
+                cube.execute(rnd_full_rotation());
+                execute_permutation(cube, rnd_permutation());
+                break;
+            case 3:
+                cube.execute(rnd_orientation());
+                execute_permutation(cube, rnd_permutation());
+                break;
+            case 4:
+                cube.execute(rnd_full_rotation());
+                cube.execute(rnd_orientation());
+                execute_permutation(cube, rnd_permutation());
+                break;
+            case 5:
+                cube.execute(rnd_orientation());
+                cube.execute(rnd_full_rotation());
+                execute_permutation(cube, rnd_permutation());
+                break;
+            default:
+                break;
+        }
+    }
+
+    // One point crossover on move segments: the segments of first before a
+    // random cut, then those of second from another random cut on
+    Cube Solver::crossover(const Cube& first, const Cube& second, const Stickers& scrambled) {
+        int prefix_end = 1 + rnd(static_cast<int>(first.move_history.size()));
+        int suffix_start = 1 + rnd(static_cast<int>(second.move_history.size()));
+
+        Cube child;
+        child.move_history.reserve(prefix_end + second.move_history.size() - suffix_start);
+        child.move_history.assign(first.move_history.begin(), first.move_history.begin() + prefix_end);
+        child.move_history.insert(child.move_history.end(),
+                                  second.move_history.begin() + suffix_start, second.move_history.end());
+        child.replay(scrambled);
+        return child;
+    }
+
+    // Moves each weight towards the fraction of this generation's children
+    // that beat their parent after being evolved with that type
+    void Solver::adapt_weights(const std::array<int, N_EVOLUTION_TYPES>& uses,
+                               const std::array<int, N_EVOLUTION_TYPES>& improvements) {
+        for (int t = 0; t < N_EVOLUTION_TYPES; ++t) {
+            if (uses[t] == 0) {
+                continue;
+            }
+            double success_rate = static_cast<double>(improvements[t]) / uses[t];
+            evolution_weights[t] = (1.0 - WEIGHT_ADAPTATION) * evolution_weights[t] + WEIGHT_ADAPTATION * success_rate;
+            evolution_weights[t] = std::max(evolution_weights[t], MIN_EVOLUTION_WEIGHT);
+        }
+    }
+
+// ---------------------------------------------------------------------------
+// Genetic algorithm
+// ---------------------------------------------------------------------------
+
+    Solver::Solver(int population_size, int max_generations, int max_resets, int elitism_num,
+                   int stagnation_limit, double crossover_rate, unsigned int seed)
+        : population_size(population_size), max_generations(max_generations),
+          max_resets(max_resets), elitism_num(elitism_num), stagnation_limit(stagnation_limit),
+          crossover_rate(crossover_rate), rng(seed) {}
+
+    Solver::Solver(const SolverConfig& config, unsigned int seed)
+        : Solver(config.population_size, config.max_generations, config.max_resets, config.elitism_num,
+                 config.stagnation_limit, config.crossover_rate, seed) {}
+
+    void Solver::enable_checkpoints(const std::string& path, int interval) {
+        checkpoint_path = path;
+        checkpoint_interval = interval;
+    }
+
+    void Solver::resume_from(const std::string& path) {
+        resume_path = path;
+    }
+
+    void Solver::set_progress_log(ProgressLog* log, int source) {
+        progress_log = log;
+        log_source = source;
+    }
+
+    SolveResult Solver::solve(const std::vector<std::string>& scramble, bool verbose,
+                              const CancellationToken* token) {
+        auto start_time = std::chrono::steady_clock::now();
+        double previous_seconds = 0.0; // time spent before the run was resumed
+        auto elapsed = [&]() {
+            return previous_seconds
+                + std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        };
+
+        SolveResult result;
+        result.scramble = scramble;
+        evolution_weights.fill(1.0 / N_EVOLUTION_TYPES);
+
+        // Logging only costs an enqueue, the log's own thread does the writing
+        ProgressLog* log = progress_log != nullptr ? progress_log : (verbose ? &ProgressLog::console() : nullptr);
+        auto emit = [&](ProgressRecord::Kind kind, int world, int generation) {
+            ProgressRecord record;
+            record.kind = kind;
+            record.source = log_source;
+            record.world = world;
+            record.generation = generation;
+            record.elapsed_us = static_cast<int64_t>(elapsed() * 1e6);
+            return record;
+        };
+        auto finish = [&]() {
+            result.seconds = elapsed();
+            if (log != nullptr) {
+                log->flush();
+            }
+            return result;
+        };
+
+        // State of the world in progress
+        std::vector<Cube> cubes;
+        int start_world = 0;
+        int start_generation = 0;
+        int world_best = -1;
+        int stagnation = 0;
+
+        if (!resume_path.empty()) {
+            SolverCheckpoint checkpoint;
+            bool matches = checkpoint.load(resume_path)
+                && checkpoint.scramble == scramble
+                && checkpoint.population_size == population_size
+                && checkpoint.max_generations == max_generations
+                && checkpoint.max_resets == max_resets
+                && checkpoint.elitism_num == elitism_num
+                && checkpoint.stagnation_limit == stagnation_limit
+                && checkpoint.crossover_rate == crossover_rate
+                && checkpoint.evolution_weights.size() == evolution_weights.size();
+            if (matches) {
+                std::istringstream(checkpoint.rng_state) >> rng;
+                std::copy(checkpoint.evolution_weights.begin(), checkpoint.evolution_weights.end(),
+                          evolution_weights.begin());
+                cubes = std::move(checkpoint.population);
+                start_world = checkpoint.world;
+                start_generation = checkpoint.generation;
+                world_best = checkpoint.world_best;
+                stagnation = checkpoint.stagnation;
+                previous_seconds = checkpoint.seconds;
+                result.fitness = checkpoint.best.fitness;
+                result.solution = checkpoint.best.solution;
+                result.world = checkpoint.best.world;
+                result.generation = checkpoint.best.generation;
+            }
+            if (log != nullptr) {
+                log->log(matches ? emit(ProgressRecord::Kind::RESUMED, start_world + 1, start_generation + 1)
+                                 : emit(ProgressRecord::Kind::RESUME_FAILED, 0, 0));
+            }
+            resume_path.clear();
+        }
+
+        auto save_checkpoint = [&](int r, int g) {
+            SolverCheckpoint checkpoint;
+            checkpoint.scramble = scramble;
+            checkpoint.population_size = population_size;
+            checkpoint.max_generations = max_generations;
+            checkpoint.max_resets = max_resets;
+            checkpoint.elitism_num = elitism_num;
+            checkpoint.stagnation_limit = stagnation_limit;
+            checkpoint.crossover_rate = crossover_rate;
+            checkpoint.world = r;
+            checkpoint.generation = g;
+            checkpoint.world_best = world_best;
+            checkpoint.stagnation = stagnation;
+            checkpoint.seconds = elapsed();
+            checkpoint.evolution_weights.assign(evolution_weights.begin(), evolution_weights.end());
+            std::ostringstream rng_state;
+            rng_state << rng;
+            checkpoint.rng_state = rng_state.str();
+            checkpoint.best = result;
+            checkpoint.population = cubes;
+            if (!checkpoint.save(checkpoint_path) && log != nullptr) {
+                log->log(emit(ProgressRecord::Kind::CHECKPOINT_FAILED, r + 1, g + 1));
+            }
+        };
+
+        if (log != nullptr) {
+            log->log(emit(ProgressRecord::Kind::STARTED, 0, 0));
+        }
+
+        // Starting point for replaying crossover children
+        Cube scrambled;
+        scrambled.execute(scramble);
+
+        for (int r = start_world; r < max_resets; ++r) {
+            if (r != start_world || cubes.empty()) {
+                // Initialize population
+                cubes.clear();
+                for (int i = 0; i < population_size; ++i) {
+                    Cube cube;
+                    cube.execute(scramble);
+                    cube.execute(rnd_single_move());
+                    cube.execute(rnd_single_move());
+                    cubes.push_back(cube);
+                }
+                start_generation = 0;
+                world_best = -1;
+                stagnation = 0;
+            }
+
+            for (int g = start_generation; g < max_generations; ++g) {
+                if (checkpoint_interval > 0 && g % checkpoint_interval == 0) {
+                    save_checkpoint(r, g);
+                }
+
+                // Sort by fitness
+                std::sort(cubes.begin(), cubes.end());
+
+                if (world_best < 0 || cubes[0].fitness < world_best) {
+                    world_best = cubes[0].fitness;
+                    stagnation = 0;
+                } else {
+                    stagnation++;
+                }
+                // Piling several steps onto every child scatters the population,
+                // so stagnation only raises the chance of one extra step
+                double mutation_rate = MAX_EXTRA_MUTATION_RATE
+                    * std::min(1.0, static_cast<double>(stagnation) / stagnation_limit);
+
+                if (log != nullptr) {
+                    ProgressRecord record = emit(ProgressRecord::Kind::GENERATION, r + 1, g + 1);
+                    record.best_fitness = cubes[0].fitness;
+                    record.diversity = population_diversity(cubes);
+                    record.mutation_rate = mutation_rate;
+                    log->log(record);
+                }
+
+                // Keep track of the best individual seen so far
+                if (result.fitness < 0 || cubes[0].fitness < result.fitness) {
+                    result.fitness = cubes[0].fitness;
+                    result.solution = cubes[0].get_algorithm();
+                    result.world = r + 1;
+                    result.generation = g + 1;
+                }
+
+                // The population is sorted, so a solved cube is always first. Checked
+                // before the token so a solve that finishes at the deadline still counts.
+                if (cubes[0].fitness == 0) {
+                    result.solved = true;
+                    return finish();
+                }
+
+                // Checked between generations, the best individual so far is already recorded
+                if (token != nullptr && token->is_cancelled()) {
+                    if (log != nullptr) {
+                        log->log(emit(ProgressRecord::Kind::CANCELLED, r + 1, g + 1));
+                    }
+                    result.cancelled = true;
+                    return finish();
+                }
+
+                if (stagnation >= stagnation_limit) {
+                    if (log != nullptr) {
+                        ProgressRecord record = emit(ProgressRecord::Kind::STAGNATED, r + 1, g + 1);
+                        record.value = stagnation;
+                        log->log(record);
+                    }
+                    break;
+                }
+
+                std::array<int, N_EVOLUTION_TYPES> uses = {};
+                std::array<int, N_EVOLUTION_TYPES> improvements = {};
+
+                for (int i = 0; i < static_cast<int>(cubes.size()); ++i) {
+                    if (i > elitism_num) {
+                        // No random draw when crossover is off, so such runs replay unchanged
+                        if (crossover_rate > 0.0 && rnd_unit() < crossover_rate) {
+                            const Cube& first = cubes[rnd(elitism_num + 1)];
+                            const Cube& second = cubes[rnd(elitism_num + 1)];
+                            cubes[i] = crossover(first, second, scrambled.stickers);
+                        } else {
+                            cubes[i] = copyCube(cubes[rnd(elitism_num + 1)]);
+                        }
+                        int parent_fitness = cubes[i].fitness;
+                        int mutations = rnd_unit() < mutation_rate ? 2 : 1;
+                        std::array<bool, N_EVOLUTION_TYPES> applied = {};
+                        for (int k = 0; k < mutations; ++k) {
+                            int evolution_type = rnd_evolution_type();
+                            evolve(cubes[i], evolution_type);
+                            applied[evolution_type] = true;
+                        }
+                        for (int t = 0; t < N_EVOLUTION_TYPES; ++t) {
+                            if (applied[t]) {
+                                uses[t]++;
+                                if (cubes[i].fitness < parent_fitness) {
+                                    improvements[t]++;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                adapt_weights(uses, improvements);
+            }
+            if (log != nullptr) {
+                log->log(emit(ProgressRecord::Kind::RESET, r + 1, 0));
+            }
+        }
+        return finish();
+    }
+
+// ---------------------------------------------------------------------------
+// Output
+// ---------------------------------------------------------------------------
+
+    void print_result(const SolveResult& result) {
+        if (!result.solved) {
+            std::cout << "Solution not found" << std::endl;
+            if (result.cancelled && !result.solution.empty()) {
+                std::cout << "Best so far: " << Cube::join(result.solution, " ") << std::endl;
+                std::cout << "Incorrect stickers: " << result.fitness << std::endl;
+            }
+            std::cout << "Time taken: " << result.seconds << " seconds" << std::endl;
+            return;
+        }
+
+        std::cout << "" << std::endl;
+        std::cout << "====================================" << std::endl;
+        std::cout << "SOLUTION FOUND" << std::endl;
+        std::cout << "====================================" << std::endl;
+        std::cout << "" << std::endl;
+        if (result.world > 0) {
+            std::cout << "World: " << result.world << " - Generation: " << result.generation << std::endl;
+            std::cout << "" << std::endl;
+        }
+        std::cout << "Scramble: " << Cube::join(result.scramble, " ") << std::endl;
+        std::cout << "" << std::endl;
+        std::cout << "Solution: " << Cube::join(result.solution, " ") << std::endl;
+        std::cout << "" << std::endl;
+        std::cout << "Moves: " << result.solution.size() << std::endl;
+        std::cout << "Time taken: " << result.seconds << " seconds" << std::endl;
+    }
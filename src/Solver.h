@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CancellationToken.h"
+#include "Cube.h"
+#include "ProgressLog.h"
+#include "SolverConfig.h"
+#include <random>
+#include <string>
+#include <vector>
+
+// Outcome of a single solve request, shared by every solver backend
+struct SolveResult {
+    bool solved = false;
+    std::vector<std::string> scramble;
+    std::vector<std::string> solution;
+    int fitness = -1;       // incorrect stickers left by the returned solution
+    int world = 0;          // GA only: world/generation the solution was found in
+    int generation = 0;
+    double seconds = 0.0;
+    bool cancelled = false; // stopped by its cancellation token, solution is the best found so far
+};
+
+// Common solve interface so a backend can be chosen per request. A solve
+// stops early once the optional token is cancelled or its deadline passes.
+class SolverBase {
+public:
+    virtual ~SolverBase() = default;
+    virtual SolveResult solve(const std::vector<std::string>& scramble, bool verbose = false,
+                              const CancellationToken* token = nullptr) = 0;
+};
+
+// Genetic algorithm solver: evolves populations of cubes by applying
+// predefined permutations, rotations and orientations on top of the scramble.
+// Each world tracks the generations since its best fitness improved: the
+// chance of a child receiving a second evolution step grows with this
+// stagnation and a world that stops improving for stagnation_limit
+// generations is reset early. The six
+// evolution types are drawn with weights adapted to how often each one
+// produced a child fitter than its parent.
+//
+// With probability crossover_rate a child is instead spliced from two elites,
+// a prefix of one parent's move segments followed by a suffix of the other's,
+// replayed from the scramble and then mutated as usual.
+//
+// All randomness comes from a seeded std::mt19937, so a run can be
+// checkpointed every few generations and resumed bit-exactly.
+class Solver : public SolverBase {
+private:
+    static const int N_EVOLUTION_TYPES = 6;
+
+    int population_size;
+    int max_generations;
+    int max_resets;
+    int elitism_num;
+    int stagnation_limit;
+    double crossover_rate;
+
+    std::array<double, N_EVOLUTION_TYPES> evolution_weights = {};
+    std::mt19937 rng;
+
+    std::string checkpoint_path;
+    int checkpoint_interval = 0;
+    std::string resume_path;
+
+    ProgressLog* progress_log = nullptr;
+    int log_source = 0;
+
+    // Additional utility functions
+    Cube copyCube(const Cube& cube_from);
+    int rnd(int n);
+    double rnd_unit();
+    Move rnd_single_move();
+    int rnd_permutation();
+    Move rnd_full_rotation();
+    Move rnd_orientation();
+    void execute_permutation(Cube& cube, int k);
+    int rnd_evolution_type();
+    void evolve(Cube& cube, int evolution_type);
+    Cube crossover(const Cube& first, const Cube& second, const Stickers& scrambled);
+    void adapt_weights(const std::array<int, N_EVOLUTION_TYPES>& uses,
+                       const std::array<int, N_EVOLUTION_TYPES>& improvements);
+
+public:
+    Solver(int population_size, int max_generations, int max_resets, int elitism_num,
+           int stagnation_limit = 60, double crossover_rate = 0.05,
+           unsigned int seed = std::random_device{}());
+    explicit Solver(const SolverConfig& config, unsigned int seed = std::random_device{}());
+
+    // Snapshot the run to path every interval generations
+    void enable_checkpoints(const std::string& path, int interval);
+    // Continue the next solve from a checkpoint of the same scramble and configuration
+    void resume_from(const std::string& path);
+    // Send progress records to log, tagged with source. Verbose solves
+    // without a log of their own print to the console log.
+    void set_progress_log(ProgressLog* log, int source = 0);
+
+    SolveResult solve(const std::vector<std::string>& scramble, bool verbose = false,
+                      const CancellationToken* token = nullptr) override;
+};
+
+void print_result(const SolveResult& result);
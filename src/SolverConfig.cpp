@@ -0,0 +1,117 @@
+#include "SolverConfig.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static bool parse_int(const std::string& value, int& out) {
+    char* end = nullptr;
+    long v = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0') {
+        return false;
+    }
+    out = static_cast<int>(v);
+    return true;
+}
+
+static bool parse_double(const std::string& value, double& out) {
+    char* end = nullptr;
+    double v = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0') {
+        return false;
+    }
+    out = v;
+    return true;
+}
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    bool SolverConfig::set(const std::string& key, const std::string& value) {
+        if (key == "population_size") {
+            return parse_int(value, population_size);
+        } else if (key == "max_generations") {
+            return parse_int(value, max_generations);
+        } else if (key == "max_resets") {
+            return parse_int(value, max_resets);
+        } else if (key == "elitism_num") {
+            return parse_int(value, elitism_num);
+        } else if (key == "stagnation_limit") {
+            return parse_int(value, stagnation_limit);
+        } else if (key == "crossover_rate") {
+            return parse_double(value, crossover_rate);
+        }
+        return false;
+    }
+
+    // Children are drawn from the first elitism_num + 1 cubes, which must exist
+    bool SolverConfig::is_valid() const {
+        return population_size > 1 && max_generations > 0 && max_resets > 0
+            && elitism_num >= 0 && elitism_num < population_size
+            && stagnation_limit > 0 && crossover_rate >= 0.0 && crossover_rate <= 1.0;
+    }
+
+    bool SolverConfig::load(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "could not open " + path;
+            return false;
+        }
+        SolverConfig loaded = *this;
+        std::string line;
+        int line_number = 0;
+        while (std::getline(in, line)) {
+            line_number++;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            size_t eq = line.find('=');
+            if (eq == std::string::npos || !loaded.set(trim(line.substr(0, eq)), trim(line.substr(eq + 1)))) {
+                error = path + ":" + std::to_string(line_number) + ": invalid line: " + line;
+                return false;
+            }
+        }
+        if (!loaded.is_valid()) {
+            error = path + ": invalid configuration: " + loaded.to_string();
+            return false;
+        }
+        *this = loaded;
+        return true;
+    }
+
+    bool SolverConfig::save(const std::string& path, const std::string& comment) const {
+        std::ofstream out(path, std::ios::trunc);
+        std::istringstream comment_lines(comment);
+        std::string line;
+        while (std::getline(comment_lines, line)) {
+            out << "# " << line << "\n";
+        }
+        out << "population_size = " << population_size << "\n";
+        out << "max_generations = " << max_generations << "\n";
+        out << "max_resets = " << max_resets << "\n";
+        out << "elitism_num = " << elitism_num << "\n";
+        out << "stagnation_limit = " << stagnation_limit << "\n";
+        out << "crossover_rate = " << crossover_rate << "\n";
+        return static_cast<bool>(out);
+    }
+
+    std::string SolverConfig::to_string() const {
+        std::ostringstream oss;
+        oss << "population_size=" << population_size
+            << " max_generations=" << max_generations
+            << " max_resets=" << max_resets
+            << " elitism_num=" << elitism_num
+            << " stagnation_limit=" << stagnation_limit
+            << " crossover_rate=" << crossover_rate;
+        return oss.str();
+    }
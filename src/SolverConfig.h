@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+// Parameters of the genetic solver. Saved as plain "key = value" lines, so a
+// configuration found by a parameter sweep can be loaded with --config.
+struct SolverConfig {
+    int population_size = 500;
+    int max_generations = 300;
+    int max_resets = 10;
+    int elitism_num = 50;
+    int stagnation_limit = 60;
+    double crossover_rate = 0.05;
+
+    // Sets one parameter by its key, returns false for unknown keys or bad values
+    bool set(const std::string& key, const std::string& value);
+    bool is_valid() const;
+
+    // Keys missing from the file keep their current value; lines starting with # are comments
+    bool load(const std::string& path, std::string& error);
+    bool save(const std::string& path, const std::string& comment = "") const;
+
+    std::string to_string() const;
+};
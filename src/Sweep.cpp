@@ -0,0 +1,252 @@
+#include "Sweep.h"
+#include "Solver.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <thread>
+
+const int MAX_RANDOM_ATTEMPTS = 1000;
+const unsigned int FIRST_SOLVER_SEED = 1000;
+
+// One solve of the sweep
+struct SweepRun {
+    int config;
+    int scramble;
+    int seed;
+    bool solved = false;
+    double seconds = 0.0;
+    int moves = 0;
+};
+
+// Nearest-rank percentile of sorted values
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+static bool is_integer(const std::string& value) {
+    return !value.empty() && value.find_first_not_of("0123456789-") == std::string::npos;
+}
+
+// Cartesian product of the axes, skipping combinations that are not valid
+static void expand_grid(const SolverConfig& config, const SweepOptions& options, size_t axis,
+                        std::vector<SolverConfig>& configs) {
+    if (axis == options.axes.size()) {
+        if (config.is_valid()) {
+            configs.push_back(config);
+        }
+        return;
+    }
+    for (const auto& value : options.axes[axis].second) {
+        SolverConfig next = config;
+        next.set(options.axes[axis].first, value);
+        expand_grid(next, options, axis + 1, configs);
+    }
+}
+
+static std::vector<SolverConfig> sample_random(const SolverConfig& base, const SweepOptions& options) {
+    std::mt19937 rng(options.corpus_seed + 1);
+    std::vector<SolverConfig> configs;
+    for (int attempt = 0; static_cast<int>(configs.size()) < options.random_samples
+                          && attempt < MAX_RANDOM_ATTEMPTS; ++attempt) {
+        SolverConfig config = base;
+        for (const auto& axis : options.axes) {
+            std::vector<double> values;
+            bool integers = true;
+            for (const auto& v : axis.second) {
+                values.push_back(std::atof(v.c_str()));
+                integers = integers && is_integer(v);
+            }
+            double lo = *std::min_element(values.begin(), values.end());
+            double hi = *std::max_element(values.begin(), values.end());
+            std::ostringstream value;
+            if (integers) {
+                value << std::uniform_int_distribution<int>(static_cast<int>(lo), static_cast<int>(hi))(rng);
+            } else {
+                value << std::uniform_real_distribution<double>(lo, hi)(rng);
+            }
+            config.set(axis.first, value.str());
+        }
+        if (config.is_valid()) {
+            configs.push_back(config);
+        }
+    }
+    return configs;
+}
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    std::vector<std::vector<std::string>> make_scramble_corpus(int count, int length, unsigned int seed) {
+        static const char FACES[] = "UDRLFB";
+        static const char* const VARIANTS[] = {"", "'", "2"};
+        std::mt19937 rng(seed);
+        std::vector<std::vector<std::string>> corpus;
+        for (int i = 0; i < count; ++i) {
+            std::vector<std::string> scramble;
+            int last_face = -1;
+            while (static_cast<int>(scramble.size()) < length) {
+                int face = static_cast<int>(rng() % 6);
+                int variant = static_cast<int>(rng() % 3);
+                if (face == last_face) {
+                    continue;
+                }
+                scramble.push_back(std::string(1, FACES[face]) + VARIANTS[variant]);
+                last_face = face;
+            }
+            corpus.push_back(scramble);
+        }
+        return corpus;
+    }
+
+    std::vector<SweepResult> run_sweep(const SolverConfig& base, const SweepOptions& options, std::ostream& out) {
+        for (const auto& axis : options.axes) {
+            for (const auto& value : axis.second) {
+                SolverConfig probe = base;
+                if (!probe.set(axis.first, value)) {
+                    out << "Invalid sweep value " << axis.first << "=" << value << std::endl;
+                    return {};
+                }
+            }
+            if (axis.second.empty()) {
+                out << "Sweep axis " << axis.first << " has no values" << std::endl;
+                return {};
+            }
+        }
+
+        std::vector<SolverConfig> configs;
+        if (options.random_samples > 0) {
+            configs = sample_random(base, options);
+        } else {
+            expand_grid(base, options, 0, configs);
+        }
+        if (configs.empty()) {
+            out << "No valid configuration to sweep" << std::endl;
+            return {};
+        }
+
+        std::vector<std::vector<std::string>> corpus =
+            make_scramble_corpus(options.scrambles, options.scramble_length, options.corpus_seed);
+
+        // Configurations are interleaved so that they all see the same machine load
+        std::vector<SweepRun> runs;
+        for (int s = 0; s < options.scrambles; ++s) {
+            for (int k = 0; k < options.seeds; ++k) {
+                for (int c = 0; c < static_cast<int>(configs.size()); ++c) {
+                    SweepRun run;
+                    run.config = c;
+                    run.scramble = s;
+                    run.seed = k;
+                    runs.push_back(run);
+                }
+            }
+        }
+
+        int n_threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        out << "Sweeping " << configs.size() << " configurations over " << options.scrambles << " scrambles x "
+            << options.seeds << " seeds (" << runs.size() << " solves) on " << n_threads << " threads" << std::endl;
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        auto work = [&]() {
+            for (size_t i = next.fetch_add(1); i < runs.size(); i = next.fetch_add(1)) {
+                SweepRun& run = runs[i];
+                Solver solver(configs[run.config], FIRST_SOLVER_SEED + run.seed);
+                CancellationToken token(options.timeout);
+                SolveResult result = solver.solve(corpus[run.scramble], false, &token);
+                run.solved = result.solved;
+                run.seconds = result.seconds;
+                run.moves = static_cast<int>(result.solution.size());
+                done.fetch_add(1);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; ++t) {
+            threads.emplace_back(work);
+        }
+
+        // Report every tenth of the solves
+        size_t reported = 0;
+        while (reported < runs.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            size_t finished = done.load();
+            if (finished * 10 / runs.size() > reported * 10 / runs.size() || finished == runs.size()) {
+                out << "\t" << finished << "/" << runs.size() << " solves" << std::endl;
+                reported = finished;
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::vector<SweepResult> results(configs.size());
+        std::vector<std::vector<double>> times(configs.size());
+        std::vector<std::vector<double>> moves(configs.size());
+        for (const auto& run : runs) {
+            SweepResult& result = results[run.config];
+            result.runs++;
+            if (run.solved) {
+                result.solved++;
+                times[run.config].push_back(run.seconds);
+                moves[run.config].push_back(run.moves);
+            } else {
+                times[run.config].push_back(std::numeric_limits<double>::infinity());
+            }
+        }
+        for (size_t c = 0; c < configs.size(); ++c) {
+            std::sort(times[c].begin(), times[c].end());
+            std::sort(moves[c].begin(), moves[c].end());
+            results[c].config = configs[c];
+            results[c].median_seconds = percentile(times[c], 0.5);
+            results[c].p95_seconds = percentile(times[c], 0.95);
+            results[c].median_moves = moves[c].empty() ? 0.0 : percentile(moves[c], 0.5);
+        }
+
+        std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+            if (a.solved != b.solved) {
+                return a.solved > b.solved;
+            }
+            if (a.median_seconds != b.median_seconds) {
+                return a.median_seconds < b.median_seconds;
+            }
+            return a.p95_seconds < b.p95_seconds;
+        });
+        return results;
+    }
+
+// ---------------------------------------------------------------------------
+// Output
+// ---------------------------------------------------------------------------
+
+    void print_sweep(const std::vector<SweepResult>& results, std::ostream& out) {
+        auto seconds = [](double s) {
+            std::ostringstream oss;
+            if (std::isinf(s)) {
+                oss << "-";
+            } else {
+                oss << std::fixed << std::setprecision(3) << s;
+            }
+            return oss.str();
+        };
+
+        out << std::left << std::setw(6) << "Rank" << std::setw(10) << "Solved" << std::setw(11) << "Median s"
+            << std::setw(10) << "P95 s" << std::setw(8) << "Moves" << "Configuration" << std::endl;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const SweepResult& r = results[i];
+            out << std::left << std::setw(6) << i + 1
+                << std::setw(10) << (std::to_string(r.solved) + "/" + std::to_string(r.runs))
+                << std::setw(11) << seconds(r.median_seconds)
+                << std::setw(10) << seconds(r.p95_seconds)
+                << std::setw(8) << r.median_moves
+                << r.config.to_string() << std::endl;
+        }
+    }
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "SolverConfig.h"
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Parameter sweep over SolverConfig on a seeded scramble corpus. Every
+// configuration solves every scramble once per seed; the solves of all
+// configurations are spread over a pool of threads.
+struct SweepOptions {
+    // Values per SolverConfig key. The grid is their cartesian product;
+    // random search draws each parameter uniformly between its smallest and
+    // largest value instead. Keys without an axis keep the base value.
+    std::vector<std::pair<std::string, std::vector<std::string>>> axes = {
+        {"population_size", {"250", "500", "1000"}},
+        {"elitism_num", {"25", "50", "100"}},
+        {"max_generations", {"150", "300"}}
+    };
+    int random_samples = 0;     // 0 runs the full grid
+    int scrambles = 10;
+    int scramble_length = 30;
+    int seeds = 2;              // solver seeds per scramble
+    unsigned int corpus_seed = 1;
+    double timeout = 10.0;      // seconds per solve, an unsolved run never counts as solved
+    int threads = 0;            // 0 uses every core
+};
+
+struct SweepResult {
+    SolverConfig config;
+    int runs = 0;
+    int solved = 0;
+    // Time to solution over all runs, unsolved runs counting as infinite,
+    // so these are infinite once more than half (or 5%) of the runs fail
+    double median_seconds = 0.0;
+    double p95_seconds = 0.0;
+    double median_moves = 0.0;  // over solved runs
+
+    double success_rate() const { return runs > 0 ? static_cast<double>(solved) / runs : 0.0; }
+};
+
+// Seeded random scrambles of face moves, no face turned twice in a row
+std::vector<std::vector<std::string>> make_scramble_corpus(int count, int length, unsigned int seed);
+
+// Runs the sweep and returns the results best first: highest success rate,
+// then lowest median and p95 time to solution. Progress goes to out.
+std::vector<SweepResult> run_sweep(const SolverConfig& base, const SweepOptions& options, std::ostream& out);
+
+// Prints the ranking as a table
+void print_sweep(const std::vector<SweepResult>& results, std::ostream& out);
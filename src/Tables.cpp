@@ -0,0 +1,243 @@
+#include "Tables.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char TABLE_MAGIC[8] = {'R', 'C', 'T', 'A', 'B', 'L', 'E', 'S'};
+const uint32_t TABLE_FORMAT_VERSION = 1;
+const size_t TABLE_ALIGNMENT = 64;
+const size_t TABLE_NAME_LENGTH = 32;
+
+struct TableFileHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t set_version;
+    uint64_t source_hash;
+    uint32_t table_count;
+    uint32_t header_size;   // header + directory, padded to TABLE_ALIGNMENT
+    uint64_t payload_size;
+    uint64_t payload_checksum;
+};
+
+struct TableFileEntry {
+    char name[TABLE_NAME_LENGTH];
+    uint64_t offset;  // from the start of the payload
+    uint64_t size;
+};
+
+static size_t align_up(size_t n) {
+    return (n + TABLE_ALIGNMENT - 1) / TABLE_ALIGNMENT * TABLE_ALIGNMENT;
+}
+
+static size_t header_size(size_t table_count) {
+    return align_up(sizeof(TableFileHeader) + table_count * sizeof(TableFileEntry));
+}
+
+// ---------------------------------------------------------------------------
+// Core Functions
+// ---------------------------------------------------------------------------
+
+    TableSet::TableSet(const std::string& set_name, uint32_t version, uint64_t source_hash, std::vector<TableSpec> specs)
+        : set_name(set_name), version(version), source_hash(source_hash), specs(std::move(specs)) {
+        for (const auto& spec : this->specs) {
+            offsets.push_back(payload_size);
+            payload_size += align_up(spec.size);
+        }
+    }
+
+    TableSet::~TableSet() {
+        if (mapping != nullptr) {
+            munmap(mapping, mapping_size);
+        }
+    }
+
+    bool TableSet::load(const std::string& path, bool verbose) {
+        if (map(path)) {
+            return true;
+        }
+
+        auto start_time = std::chrono::steady_clock::now();
+        generate();
+        if (verbose) {
+            std::cout << "Generated " << set_name << " tables ("
+                      << payload_size / (1024 * 1024) << " MB) in "
+                      << std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count()
+                      << " seconds" << std::endl;
+        }
+
+        // Prefer the shared mapping of the file just written over the private buffer
+        if (write(path) && map(path)) {
+            buffer.clear();
+            buffer.shrink_to_fit();
+        } else if (verbose) {
+            std::cout << "Could not cache tables to " << path << std::endl;
+        }
+        return false;
+    }
+
+    const uint8_t* TableSet::get(const std::string& name) const {
+        for (size_t i = 0; i < specs.size(); ++i) {
+            if (specs[i].name == name) {
+                return payload + offsets[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // 64-bit FNV-1a over whole words, the tail is folded in byte by byte
+    uint64_t TableSet::checksum(const uint8_t* data, size_t size, uint64_t seed) {
+        const uint64_t PRIME = 0x100000001b3ULL;
+        uint64_t hash = seed;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * PRIME;
+        }
+        for (; i < size; ++i) {
+            hash = (hash ^ data[i]) * PRIME;
+        }
+        return hash;
+    }
+
+// ---------------------------------------------------------------------------
+// File handling
+// ---------------------------------------------------------------------------
+
+    bool TableSet::map(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        size_t expected_size = header_size(specs.size()) + payload_size;
+        struct stat st;
+        void* file = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == expected_size) {
+            file = mmap(nullptr, expected_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (file == MAP_FAILED) {
+            return false;
+        }
+
+        // Validate the header and directory against the specs before trusting the payload
+        const uint8_t* bytes = static_cast<const uint8_t*>(file);
+        const TableFileHeader* header = reinterpret_cast<const TableFileHeader*>(bytes);
+        const TableFileEntry* entries = reinterpret_cast<const TableFileEntry*>(bytes + sizeof(TableFileHeader));
+        bool valid = std::memcmp(header->magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) == 0
+            && header->format_version == TABLE_FORMAT_VERSION
+            && header->set_version == version
+            && header->source_hash == source_hash
+            && header->table_count == specs.size()
+            && header->header_size == header_size(specs.size())
+            && header->payload_size == payload_size;
+        for (size_t i = 0; valid && i < specs.size(); ++i) {
+            valid = std::strncmp(entries[i].name, specs[i].name.c_str(), TABLE_NAME_LENGTH) == 0
+                && entries[i].offset == offsets[i]
+                && entries[i].size == specs[i].size;
+        }
+        const uint8_t* file_payload = bytes + header_size(specs.size());
+        if (valid) {
+            valid = checksum(file_payload, payload_size) == header->payload_checksum;
+        }
+
+        if (!valid) {
+            munmap(file, expected_size);
+            return false;
+        }
+
+        if (mapping != nullptr) {
+            munmap(mapping, mapping_size);
+        }
+        mapping = file;
+        mapping_size = expected_size;
+        payload = file_payload;
+        return true;
+    }
+
+    bool TableSet::write(const std::string& path) const {
+        std::vector<uint8_t> header(header_size(specs.size()), 0);
+        TableFileHeader* h = reinterpret_cast<TableFileHeader*>(header.data());
+        std::memcpy(h->magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+        h->format_version = TABLE_FORMAT_VERSION;
+        h->set_version = version;
+        h->source_hash = source_hash;
+        h->table_count = static_cast<uint32_t>(specs.size());
+        h->header_size = static_cast<uint32_t>(header.size());
+        h->payload_size = payload_size;
+        h->payload_checksum = checksum(buffer.data(), payload_size);
+
+        TableFileEntry* entries = reinterpret_cast<TableFileEntry*>(header.data() + sizeof(TableFileHeader));
+        for (size_t i = 0; i < specs.size(); ++i) {
+            std::strncpy(entries[i].name, specs[i].name.c_str(), TABLE_NAME_LENGTH - 1);
+            entries[i].offset = offsets[i];
+            entries[i].size = specs[i].size;
+        }
+
+        // Write to a temporary file first so a concurrent reader never maps a partial file
+        std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(header.data()), header.size());
+            out.write(reinterpret_cast<const char*>(buffer.data()), payload_size);
+            if (!out) {
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+        }
+        return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+    }
+
+// ---------------------------------------------------------------------------
+// Generation
+// ---------------------------------------------------------------------------
+
+    void TableSet::generate() {
+        buffer.assign(payload_size, 0);
+        payload = buffer.data();
+
+        int last_stage = 0;
+        for (const auto& spec : specs) {
+            last_stage = std::max(last_stage, spec.stage);
+        }
+
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        for (int stage = 0; stage <= last_stage; ++stage) {
+            std::vector<size_t> pending;
+            for (size_t i = 0; i < specs.size(); ++i) {
+                if (specs[i].stage == stage) {
+                    pending.push_back(i);
+                }
+            }
+
+            // Workers pull the next table of the stage until none are left
+            std::atomic<size_t> next(0);
+            auto worker = [&]() {
+                for (size_t k = next++; k < pending.size(); k = next++) {
+                    size_t i = pending[k];
+                    specs[i].generate(buffer.data() + offsets[i], *this);
+                }
+            };
+
+            size_t n_threads = std::min<size_t>(cores, pending.size());
+            std::vector<std::thread> threads;
+            for (size_t t = 1; t < n_threads; ++t) {
+                threads.emplace_back(worker);
+            }
+            worker();
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+    }
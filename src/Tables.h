@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class TableSet;
+
+// Description of one table of a TableSet. Tables of the same stage are
+// generated in parallel once every table of an earlier stage is complete,
+// so a generator may read tables of earlier stages through the set.
+struct TableSpec {
+    std::string name;
+    size_t size;  // bytes
+    int stage;
+    std::function<void(uint8_t* out, const TableSet& set)> generate;
+};
+
+// A group of precomputed tables stored in one binary file:
+//
+//   header     magic, format version, set version, source hash,
+//              table count, payload size and payload checksum
+//   directory  name, offset and size of every table
+//   payload    the tables, each aligned to 64 bytes
+//
+// load() memory-maps the file read-only so startup is cheap and several
+// processes share the same pages. A missing, stale or corrupt file is
+// regenerated and atomically replaced.
+class TableSet {
+private:
+    std::string set_name;
+    uint32_t version;
+    uint64_t source_hash;
+    std::vector<TableSpec> specs;
+    std::vector<size_t> offsets;
+    size_t payload_size = 0;
+
+    std::vector<uint8_t> buffer;  // used while generating or if the file cannot be mapped
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    const uint8_t* payload = nullptr;
+
+    bool map(const std::string& path);
+    void generate();
+    bool write(const std::string& path) const;
+
+public:
+    // source_hash identifies the definitions the tables are derived from;
+    // files built from different definitions are treated as stale
+    TableSet(const std::string& set_name, uint32_t version, uint64_t source_hash, std::vector<TableSpec> specs);
+    ~TableSet();
+    TableSet(const TableSet&) = delete;
+    TableSet& operator=(const TableSet&) = delete;
+
+    // Returns true if the tables were mapped from an existing file
+    bool load(const std::string& path, bool verbose = false);
+
+    const uint8_t* get(const std::string& name) const;
+    bool is_mapped() const { return mapping != nullptr; }
+    size_t size() const { return payload_size; }
+
+    static uint64_t checksum(const uint8_t* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL);
+};
@@ -0,0 +1,352 @@
+#include "TwoPhaseSolver.h"
+#include "Tables.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+
+const int N_MOVES = CubieCube::N_MOVES;
+const int MAX_DEPTH = 32;
+const long REFINE_NODES = 200000;  // search nodes without a shorter solution before refinement stops
+const uint8_t EMPTY = 0xFF;
+
+// The moves of <U, D, R2, L2, F2, B2>
+const std::vector<int> PHASE2_MOVES = {0, 1, 2, 4, 7, 9, 10, 11, 13, 16};
+
+// Bump when a coordinate definition or table layout changes
+const uint32_t TABLES_VERSION = 1;
+
+static bool is_phase2_move(int m) {
+    int face = m / 3;
+    return face == 0 || face == 3 || m % 3 == 1;
+}
+
+// Consecutive turns of the same face are merged, and of two opposite faces
+// only the order U before D, R before L, F before B is searched
+static bool redundant(int last, int m) {
+    int last_face = last / 3;
+    int face = m / 3;
+    return face == last_face || face == last_face - 3;
+}
+
+// ---------------------------------------------------------------------------
+// Table generation
+// ---------------------------------------------------------------------------
+
+// Fills table[coord][m] by decoding each coordinate into a cubie cube,
+// applying the move and encoding the result again
+template <typename Set, typename Get>
+static void build_move_table(uint16_t* table, int n, const std::vector<int>& moves, Set set, Get get) {
+    for (int i = 0; i < n; ++i) {
+        for (int m : moves) {
+            CubieCube cc;
+            set(cc, i);
+            cc.move(m);
+            table[i * N_MOVES + m] = static_cast<uint16_t>(get(cc));
+        }
+    }
+}
+
+// Breadth first search from the solved state over the product of two
+// coordinates; index = c1 * n2 + c2
+static void build_prune_table(uint8_t* table, int n1, int n2,
+                              const uint16_t* move1, const uint16_t* move2,
+                              const std::vector<int>& moves) {
+    size_t total = static_cast<size_t>(n1) * n2;
+    std::fill(table, table + total, EMPTY);
+    table[0] = 0;
+
+    size_t filled = 1;
+    for (uint8_t depth = 0; filled < total; ++depth) {
+        for (size_t idx = 0; idx < total; ++idx) {
+            if (table[idx] != depth) {
+                continue;
+            }
+            int c1 = static_cast<int>(idx / n2);
+            int c2 = static_cast<int>(idx % n2);
+            for (int m : moves) {
+                size_t next = static_cast<size_t>(move1[c1 * N_MOVES + m]) * n2 + move2[c2 * N_MOVES + m];
+                if (table[next] == EMPTY) {
+                    table[next] = depth + 1;
+                    filled++;
+                }
+            }
+        }
+    }
+}
+
+static std::vector<TableSpec> table_specs() {
+    std::vector<int> all_moves;
+    for (int m = 0; m < N_MOVES; ++m) {
+        all_moves.push_back(m);
+    }
+
+    auto move_table = [](const std::string& name, int n, const std::vector<int>& moves,
+                         void (CubieCube::*set)(int), int (CubieCube::*get)() const) {
+        return TableSpec{name, n * N_MOVES * sizeof(uint16_t), 0,
+            [=](uint8_t* out, const TableSet&) {
+                build_move_table(reinterpret_cast<uint16_t*>(out), n, moves,
+                    [set](CubieCube& cc, int i) { (cc.*set)(i); },
+                    [get](const CubieCube& cc) { return (cc.*get)(); });
+            }};
+    };
+
+    // Pruning tables read the move tables generated in the previous stage
+    auto prune_table = [](const std::string& name, int n1, int n2,
+                          const std::string& move1, const std::string& move2, const std::vector<int>& moves) {
+        return TableSpec{name, static_cast<size_t>(n1) * n2, 1,
+            [=](uint8_t* out, const TableSet& set) {
+                build_prune_table(out, n1, n2,
+                    reinterpret_cast<const uint16_t*>(set.get(move1)),
+                    reinterpret_cast<const uint16_t*>(set.get(move2)), moves);
+            }};
+    };
+
+    return {
+        move_table("twist_move", CubieCube::N_TWIST, all_moves, &CubieCube::set_twist, &CubieCube::get_twist),
+        move_table("flip_move", CubieCube::N_FLIP, all_moves, &CubieCube::set_flip, &CubieCube::get_flip),
+        move_table("slice_move", CubieCube::N_SLICE, all_moves, &CubieCube::set_slice, &CubieCube::get_slice),
+        move_table("corner_perm_move", CubieCube::N_CORNER_PERM, all_moves,
+                   &CubieCube::set_corner_perm, &CubieCube::get_corner_perm),
+        move_table("ud_edge_perm_move", CubieCube::N_UD_EDGE_PERM, PHASE2_MOVES,
+                   &CubieCube::set_ud_edge_perm, &CubieCube::get_ud_edge_perm),
+        move_table("slice_perm_move", CubieCube::N_SLICE_PERM, PHASE2_MOVES,
+                   &CubieCube::set_slice_perm, &CubieCube::get_slice_perm),
+        prune_table("slice_twist_prune", CubieCube::N_TWIST, CubieCube::N_SLICE,
+                    "twist_move", "slice_move", all_moves),
+        prune_table("slice_flip_prune", CubieCube::N_FLIP, CubieCube::N_SLICE,
+                    "flip_move", "slice_move", all_moves),
+        prune_table("corner_slice_prune", CubieCube::N_CORNER_PERM, CubieCube::N_SLICE_PERM,
+                    "corner_perm_move", "slice_perm_move", PHASE2_MOVES),
+        prune_table("edge_slice_prune", CubieCube::N_UD_EDGE_PERM, CubieCube::N_SLICE_PERM,
+                    "ud_edge_perm_move", "slice_perm_move", PHASE2_MOVES)
+    };
+}
+
+// Fingerprint of the cubie moves derived from Cube, stale tables are
+// regenerated if the move definitions ever change
+static uint64_t move_definitions_hash() {
+    uint64_t hash = TableSet::checksum(nullptr, 0);
+    for (const CubieCube& cc : CubieCube::basic_moves()) {
+        hash = TableSet::checksum(reinterpret_cast<const uint8_t*>(cc.cp.data()), cc.cp.size(), hash);
+        hash = TableSet::checksum(reinterpret_cast<const uint8_t*>(cc.co.data()), cc.co.size(), hash);
+        hash = TableSet::checksum(reinterpret_cast<const uint8_t*>(cc.ep.data()), cc.ep.size(), hash);
+        hash = TableSet::checksum(reinterpret_cast<const uint8_t*>(cc.eo.data()), cc.eo.size(), hash);
+    }
+    return hash;
+}
+
+const TwoPhaseTables& TwoPhaseTables::load(const std::string& path, bool verbose) {
+    struct Loaded {
+        std::unique_ptr<TableSet> set;
+        TwoPhaseTables tables;
+    };
+    static std::mutex mutex;
+    static std::map<std::string, Loaded> loaded;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = loaded.find(path);
+    if (it != loaded.end()) {
+        return it->second.tables;
+    }
+
+    Loaded& entry = loaded[path];
+    entry.set.reset(new TableSet("two-phase", TABLES_VERSION, move_definitions_hash(), table_specs()));
+    entry.set->load(path, verbose);
+
+    const TableSet& set = *entry.set;
+    auto u16 = [&set](const char* name) { return reinterpret_cast<const uint16_t*>(set.get(name)); };
+    TwoPhaseTables& t = entry.tables;
+    t.twist_move = u16("twist_move");
+    t.flip_move = u16("flip_move");
+    t.slice_move = u16("slice_move");
+    t.corner_perm_move = u16("corner_perm_move");
+    t.ud_edge_perm_move = u16("ud_edge_perm_move");
+    t.slice_perm_move = u16("slice_perm_move");
+    t.slice_twist_prune = set.get("slice_twist_prune");
+    t.slice_flip_prune = set.get("slice_flip_prune");
+    t.corner_slice_prune = set.get("corner_slice_prune");
+    t.edge_slice_prune = set.get("edge_slice_prune");
+    return t;
+}
+
+// ---------------------------------------------------------------------------
+// Search
+// ---------------------------------------------------------------------------
+
+    TwoPhaseSolver::TwoPhaseSolver(int max_length, int target_length, const std::string& table_path, bool verbose)
+        : max_length(std::min(max_length, MAX_DEPTH)), target_length(target_length),
+          tables(TwoPhaseTables::load(table_path, verbose)), moves(MAX_DEPTH), twist(MAX_DEPTH + 1),
+          flip(MAX_DEPTH + 1), slice(MAX_DEPTH + 1), corner_perm(MAX_DEPTH + 1), ud_edge_perm(MAX_DEPTH + 1),
+          slice_perm(MAX_DEPTH + 1), best_moves(MAX_DEPTH) {}
+
+    bool TwoPhaseSolver::refinement_spent() const {
+        return solution_length >= 0 && nodes - improved_nodes >= REFINE_NODES;
+    }
+
+    bool TwoPhaseSolver::should_stop() {
+        if ((++nodes & 0xFFF) == 0 && token != nullptr && token->is_cancelled()) {
+            cancelled = true;
+        }
+        return cancelled || refinement_spent();
+    }
+
+    // Returns true once the search can stop: the solution is short enough
+    bool TwoPhaseSolver::phase1(int depth, int togo) {
+        if (should_stop()) {
+            return false;
+        }
+        if (togo == 0) {
+            // The last phase 1 move must leave the subgroup, otherwise a
+            // shorter phase 1 solution was already tried
+            if (twist[depth] == 0 && flip[depth] == 0 && slice[depth] == 0
+                && (depth == 0 || !is_phase2_move(moves[depth - 1]))) {
+                return phase2(depth);
+            }
+            return false;
+        }
+
+        for (int m = 0; m < N_MOVES; ++m) {
+            if (depth > 0 && redundant(moves[depth - 1], m)) {
+                continue;
+            }
+            int t = tables.twist_move[twist[depth] * N_MOVES + m];
+            int f = tables.flip_move[flip[depth] * N_MOVES + m];
+            int s = tables.slice_move[slice[depth] * N_MOVES + m];
+            int dist = std::max(tables.slice_twist_prune[t * CubieCube::N_SLICE + s],
+                                tables.slice_flip_prune[f * CubieCube::N_SLICE + s]);
+            if (dist >= togo) {
+                continue;
+            }
+            moves[depth] = m;
+            twist[depth + 1] = t;
+            flip[depth + 1] = f;
+            slice[depth + 1] = s;
+            if (phase1(depth + 1, togo - 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TwoPhaseSolver::phase2(int depth1) {
+        // Phase 2 coordinates are not tracked through phase 1, so replay the
+        // phase 1 moves on the cubie cube
+        CubieCube cc = start;
+        for (int i = 0; i < depth1; ++i) {
+            cc.move(moves[i]);
+        }
+        corner_perm[depth1] = cc.get_corner_perm();
+        ud_edge_perm[depth1] = cc.get_ud_edge_perm();
+        slice_perm[depth1] = cc.get_slice_perm();
+
+        int dist = std::max(
+            tables.corner_slice_prune[corner_perm[depth1] * CubieCube::N_SLICE_PERM + slice_perm[depth1]],
+            tables.edge_slice_prune[ud_edge_perm[depth1] * CubieCube::N_SLICE_PERM + slice_perm[depth1]]);
+        // Only a solution shorter than the best one so far is of interest
+        int limit = solution_length < 0 ? max_length : solution_length - 1;
+        for (int depth2 = dist; depth1 + depth2 <= limit; ++depth2) {
+            if (phase2_search(depth1, depth2)) {
+                phase1_length = depth1;
+                solution_length = depth1 + depth2;
+                improved_nodes = nodes;
+                std::copy(moves.begin(), moves.begin() + solution_length, best_moves.begin());
+                return solution_length <= target_length;
+            }
+        }
+        return false;
+    }
+
+    bool TwoPhaseSolver::phase2_search(int depth, int togo) {
+        if (should_stop()) {
+            return false;
+        }
+        if (togo == 0) {
+            return corner_perm[depth] == 0 && ud_edge_perm[depth] == 0 && slice_perm[depth] == 0;
+        }
+
+        for (int m : PHASE2_MOVES) {
+            if (depth > 0 && redundant(moves[depth - 1], m)) {
+                continue;
+            }
+            int c = tables.corner_perm_move[corner_perm[depth] * N_MOVES + m];
+            int e = tables.ud_edge_perm_move[ud_edge_perm[depth] * N_MOVES + m];
+            int s = tables.slice_perm_move[slice_perm[depth] * N_MOVES + m];
+            int dist = std::max(tables.corner_slice_prune[c * CubieCube::N_SLICE_PERM + s],
+                                tables.edge_slice_prune[e * CubieCube::N_SLICE_PERM + s]);
+            if (dist >= togo) {
+                continue;
+            }
+            moves[depth] = m;
+            corner_perm[depth + 1] = c;
+            ud_edge_perm[depth + 1] = e;
+            slice_perm[depth + 1] = s;
+            if (phase2_search(depth + 1, togo - 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    SolveResult TwoPhaseSolver::solve(const std::vector<std::string>& scramble, bool verbose,
+                                      const CancellationToken* token) {
+        auto start_time = std::chrono::steady_clock::now();
+
+        SolveResult result;
+        result.scramble = scramble;
+
+        Cube cube;
+        cube.execute(scramble);
+        if (!CubieCube::from_cube(cube, start)) {
+            if (verbose) {
+                std::cout << "Cube state is not solvable" << std::endl;
+            }
+            result.fitness = cube.fitness;
+            return result;
+        }
+
+        twist[0] = start.get_twist();
+        flip[0] = start.get_flip();
+        slice[0] = start.get_slice();
+        solution_length = -1;
+        this->token = token;
+        nodes = 0;
+        improved_nodes = 0;
+        cancelled = false;
+
+        // A phase 1 as long as the best solution cannot lead to a shorter one
+        for (int depth1 = 0; depth1 <= max_length && (solution_length < 0 || depth1 < solution_length)
+                             && !cancelled && !refinement_spent(); ++depth1) {
+            if (verbose) {
+                std::cout << "\tPhase 1 depth: " << depth1 << std::endl;
+            }
+            if (phase1(0, depth1)) {
+                break;
+            }
+        }
+
+        if (solution_length >= 0) {
+            for (int i = 0; i < solution_length; ++i) {
+                result.solution.push_back(CubieCube::move_name(best_moves[i]));
+            }
+            cube.execute(result.solution);
+            result.fitness = cube.fitness;
+            result.solved = cube.is_solved();
+            if (verbose) {
+                std::cout << "Phase 1: " << phase1_length << " moves - Phase 2: "
+                          << solution_length - phase1_length << " moves" << std::endl;
+            }
+        } else {
+            // Phase 1 has no partial solutions, so a cancelled search returns the scramble as is
+            result.fitness = cube.fitness;
+            result.cancelled = cancelled;
+            if (verbose && cancelled) {
+                std::cout << "Search cancelled" << std::endl;
+            }
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return result;
+    }
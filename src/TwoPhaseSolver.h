@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CubieCube.h"
+#include "Solver.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Move and pruning tables of the two-phase algorithm, views into a TableSet
+// that is generated once and memory-mapped from its cache file afterwards.
+struct TwoPhaseTables {
+    const uint16_t* twist_move = nullptr;         // [N_TWIST][N_MOVES]
+    const uint16_t* flip_move = nullptr;          // [N_FLIP][N_MOVES]
+    const uint16_t* slice_move = nullptr;         // [N_SLICE][N_MOVES]
+    const uint16_t* corner_perm_move = nullptr;   // [N_CORNER_PERM][N_MOVES]
+    const uint16_t* ud_edge_perm_move = nullptr;  // [N_UD_EDGE_PERM][N_MOVES], phase 2 moves only
+    const uint16_t* slice_perm_move = nullptr;    // [N_SLICE_PERM][N_MOVES], phase 2 moves only
+
+    const uint8_t* slice_twist_prune = nullptr;   // [N_TWIST * N_SLICE]
+    const uint8_t* slice_flip_prune = nullptr;    // [N_FLIP * N_SLICE]
+    const uint8_t* corner_slice_prune = nullptr;  // [N_CORNER_PERM * N_SLICE_PERM]
+    const uint8_t* edge_slice_prune = nullptr;    // [N_UD_EDGE_PERM * N_SLICE_PERM]
+
+    // Returns the process wide tables, generating or mapping them on first use.
+    // verbose reports a generation or a failure to cache the tables.
+    static const TwoPhaseTables& load(const std::string& path, bool verbose = false);
+};
+
+// Deterministic two-phase (Kociemba) solver. Phase 1 brings the cube into
+// the subgroup <U, D, R2, L2, F2, B2>, phase 2 solves it within that group.
+// Both phases are IDA* searches over coordinates using the pruning tables
+// as admissible heuristics, so solves are bounded and solutions short.
+//
+// The first solution found is refined: phase 1 keeps searching deeper while
+// it is shorter than the best solution, and phase 2 only accepts shorter
+// totals. Refinement stops once the solution is at most target_length
+// moves, no shorter one can exist, a fixed budget of search nodes passes
+// without an improvement or the token is cancelled.
+class TwoPhaseSolver : public SolverBase {
+private:
+    int max_length;
+    int target_length;
+    const TwoPhaseTables& tables;
+
+    // Search state, indexed by depth
+    CubieCube start;
+    std::vector<int> moves;
+    std::vector<int> twist;
+    std::vector<int> flip;
+    std::vector<int> slice;
+    std::vector<int> corner_perm;
+    std::vector<int> ud_edge_perm;
+    std::vector<int> slice_perm;
+    std::vector<int> best_moves;
+    int phase1_length = 0;
+    int solution_length = -1;
+
+    // Cancellation is polled every few thousand search nodes
+    const CancellationToken* token = nullptr;
+    long nodes = 0;
+    long improved_nodes = 0;  // nodes searched when the best solution was found
+    bool cancelled = false;
+
+    bool refinement_spent() const;
+    bool should_stop();
+    bool phase1(int depth, int togo);
+    bool phase2(int depth1);
+    bool phase2_search(int depth, int togo);
+
+public:
+    // A target_length of 0 keeps refining until the node budget or the token stops it
+    explicit TwoPhaseSolver(int max_length = 22, int target_length = 0,
+                            const std::string& table_path = "twophase_tables.bin", bool verbose = false);
+
+    SolveResult solve(const std::vector<std::string>& scramble, bool verbose = false,
+                      const CancellationToken* token = nullptr) override;
+};
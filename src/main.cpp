@@ -1,220 +1,215 @@
 #include "Cube.h"
+#include "Daemon.h"
+#include "Solver.h"
+#include "Sweep.h"
+#include "TwoPhaseSolver.h"
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <algorithm>
 #include <vector>
 #include <string>
-#include <random>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
 
-const std::vector<std::string> SINGLE_MOVES = {"U", "U'", "U2", "D", "D'", "D2", 
-                                               "R", "R'", "R2", "L", "L'", "L2", 
-                                               "F", "F'", "F2", "B", "B'", "B2"};
-
-const std::vector<std::string> FULL_ROTATIONS = {"x", "x'", "x2", "y", "y'", "y2"};
-
-const std::vector<std::string> ORIENTATIONS = {"z", "z'", "z2"};
-
-const std::vector<std::vector<std::string>> PERMUTATIONS = {
-    // Permutes two edges: U face, bottom edge and right edge
-    {"F'", "L'", "B'", "R'", "U'", "R", "U'", "B", "L", "F", "R", "U", "R'", "U"},
-    
-    // Permutes two edges: U face, bottom edge and left edge
-    {"F", "R", "B", "L", "U", "L'", "U", "B'", "R'", "F'", "L'", "U'", "L", "U'"},
-    
-    // Permutes two corners: U face, bottom left and bottom right
-    {"U2", "B", "U2", "B'", "R2", "F", "R'", "F'", "U2", "F'", "U2", "F", "R'"},
-    
-    // Permutes three corners: U face, bottom left and top left
-    {"U2", "R", "U2", "R'", "F2", "L", "F'", "L'", "U2", "L'", "U2", "L", "F'"},
-    
-    // Permutes three centers: F face, top, right, bottom
-    {"U'", "B2", "D2", "L'", "F2", "D2", "B2", "R'", "U'"},
-    
-    // Permutes three centers: F face, top, right, left
-    {"U", "B2", "D2", "R", "F2", "D2", "B2", "L", "U"},
-    
-    // U face: bottom edge <-> right edge, bottom right corner <-> top right corner
-    {"D'", "R'", "D", "R2", "U'", "R", "B2", "L", "U'", "L'", "B2", "U", "R2"},
-    
-    // U face: bottom edge <-> right edge, bottom right corner <-> left right corner
-    {"D", "L", "D'", "L2", "U", "L'", "B2", "R'", "U", "R", "B2", "U'", "L2"},
-    
-    // U face: top edge <-> bottom edge, bottom left corner <-> top right corner
-    {"R'", "U", "L'", "U2", "R", "U'", "L", "R'", "U", "L'", "U2", "R", "U'", "L", "U'"},
-    
-    // U face: top edge <-> bottom edge, bottom right corner <-> top left corner
-    {"L", "U'", "R", "U2", "L'", "U", "R'", "L", "U'", "R", "U2", "L'", "U", "R'", "U"},
-    
-    // Permutes three corners: U face, bottom right, bottom left and top left
-    {"F'", "U", "B", "U'", "F", "U", "B'", "U'"},
-    
-    // Permutes three corners: U face, bottom left, bottom right and top right
-    {"F", "U'", "B'", "U", "F'", "U'", "B", "U"},
-    
-    // Permutes three edges: F face bottom, F face top, B face top
-    {"L'", "U2", "L", "R'", "F2", "R"},
-    
-    // Permutes three edges: F face top, B face top, B face bottom
-    {"R'", "U2", "R", "L'", "B2", "L"},
-    
-    // H permutation: U Face, swaps the edges horizontally and vertically
-    {"M2", "U", "M2", "U2", "M2", "U", "M2"}
-};
+int main(int argc, char* argv[]) {
+    // Remove the comment when you use the desired scramble sequence
+    // std::vector<std::string> scramble = {"R'", "U'", "L2", "B2", "U2", "F", "L2", "B'", "L'", "B", "D", "R", "B", "F2", "L", "F", "R'", "B2", "F'", "L", "B'", "D", "B2", "R2", "D'", "U", "B2", "F'", "D", "R2"};
+    // std::vector<std::string> scramble = {"U2", "B'", "F", "L", "B'", "F2", "D'", "U", "B2", "R'", "U", "B'", "F", "U", "F'", "R'", "U2", "L'", "R'", "D", "F2", "R'", "F'", "D2", "L'", "R2", "B'", "D", "L", "U2"};
+    std::vector<std::string> scramble = {"B'", "R'", "U2", "B'", "F", "D2", "R2", "B", "F'", "L2", "R'", "B2", "D2", "L2", "F'", "U", "L", "B2", "D", "F", "L'", "F", "R", "B2", "D'", "U'", "B'", "L'", "B'", "F2"};
+    // std::vector<std::string> scramble = {"D'", "B2", "D2", "L2", "U'", "L", "R'", "F", "L2", "R2", "U'", "L2", "B'", "L", "D'", "B2", "R2", "B'", "R", "F", "U2", "R", "B2", "F'", "L'", "B2", "L2", "R", "F2", "L'"};
 
-class Solver {
-private:
-    int last_printed_world = -1;
-    int population_size;
-    int max_generations;
-    int max_resets;
-    int elitism_num;
-    
-    // Additional utility functions
-    Cube copyCube(const Cube& cube_from) {
-        Cube cube_to;
-        cube_to.faces = cube_from.faces;
-        cube_to.move_history = cube_from.move_history;
-        cube_to.fitness = cube_from.fitness;
-        return cube_to;
+    // Population size, generation and reset limits, elitism and crossover rate
+    // of the genetic solver; the defaults are in SolverConfig.h
+    SolverConfig config;
+
+    // --two-phase selects the two-phase backend, the genetic solver is the default.
+    // --timeout <seconds> bounds the solve and reports the best state found so far.
+    // --seed <n> makes a genetic run reproducible.
+    // --config <file> loads the genetic solver parameters, for example as written by --sweep.
+    // --crossover <rate> sets the share of genetic children spliced from two parents.
+    // --checkpoint <file> snapshots a genetic run every --checkpoint-interval <n> generations,
+    // --resume <file> continues one.
+    // --log-format <text|jsonl> and --log-file <file> choose where genetic progress records go.
+    // --daemon <socket> serves solve requests on a Unix domain socket with --workers <n> threads,
+    // --client <socket> sends the scrambles read from stdin to one (see Daemon.h for the protocol).
+    // --sweep <file> tunes the genetic parameters on a seeded scramble corpus and writes the best
+    // configuration to file. --sweep-axis <key=v1,v2,...> sets the values swept for a parameter,
+    // --sweep-random <n> samples n configurations instead of running the grid,
+    // --sweep-scrambles <n> and --sweep-seeds <n> size the corpus. --timeout bounds each solve,
+    // --workers sets the number of threads.
+    bool two_phase = false;
+    double timeout = 0.0;
+    unsigned int seed = static_cast<unsigned int>(time(nullptr));
+    std::string checkpoint_path;
+    int checkpoint_interval = 10;
+    std::string resume_path;
+    std::string log_format = "text";
+    std::string log_path;
+    std::string daemon_path;
+    std::string client_path;
+    int workers = 0;
+    std::string config_path;
+    const char* crossover_rate = nullptr;
+    std::string sweep_path;
+    SweepOptions sweep_options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--two-phase") == 0) {
+            two_phase = true;
+        } else if (std::strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeout = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--crossover") == 0 && i + 1 < argc) {
+            crossover_rate = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpoint_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc) {
+            checkpoint_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+            resume_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--log-format") == 0 && i + 1 < argc) {
+            log_format = argv[++i];
+        } else if (std::strcmp(argv[i], "--log-file") == 0 && i + 1 < argc) {
+            log_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--daemon") == 0 && i + 1 < argc) {
+            daemon_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--client") == 0 && i + 1 < argc) {
+            client_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) {
+            sweep_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--sweep-axis") == 0 && i + 1 < argc) {
+            std::string axis = argv[++i];
+            size_t eq = axis.find('=');
+            std::string key = axis.substr(0, eq);
+            std::vector<std::string> values;
+            std::stringstream list(eq == std::string::npos ? "" : axis.substr(eq + 1));
+            std::string value;
+            while (std::getline(list, value, ',')) {
+                values.push_back(value);
+            }
+            auto it = std::find_if(sweep_options.axes.begin(), sweep_options.axes.end(),
+                                   [&](const std::pair<std::string, std::vector<std::string>>& a) { return a.first == key; });
+            if (it != sweep_options.axes.end()) {
+                it->second = values;
+            } else {
+                sweep_options.axes.push_back({key, values});
+            }
+        } else if (std::strcmp(argv[i], "--sweep-random") == 0 && i + 1 < argc) {
+            sweep_options.random_samples = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep-scrambles") == 0 && i + 1 < argc) {
+            sweep_options.scrambles = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep-seeds") == 0 && i + 1 < argc) {
+            sweep_options.seeds = std::atoi(argv[++i]);
+        }
     }
 
-    std::string rnd_single_move() {
-        return SINGLE_MOVES[rand() % SINGLE_MOVES.size()];
+    if (!config_path.empty()) {
+        std::string error;
+        if (!config.load(config_path, error)) {
+            std::cerr << "Could not load config: " << error << std::endl;
+            return 1;
+        }
     }
-
-    std::vector<std::string> rnd_permutation() {
-        return PERMUTATIONS[rand() % PERMUTATIONS.size()];
+    if (crossover_rate && !(config.set("crossover_rate", crossover_rate) && config.is_valid())) {
+        std::cerr << "Invalid --crossover " << crossover_rate << ", expected a rate between 0 and 1" << std::endl;
+        return 1;
     }
 
-    std::string rnd_full_rotation() {
-        return FULL_ROTATIONS[rand() % FULL_ROTATIONS.size()];
+    if (!sweep_path.empty()) {
+        sweep_options.threads = workers;
+        if (timeout > 0.0) {
+            sweep_options.timeout = timeout;
+        }
+        std::vector<SweepResult> results = run_sweep(config, sweep_options, std::cout);
+        if (results.empty()) {
+            return 1;
+        }
+        print_sweep(results, std::cout);
+
+        const SweepResult& best = results[0];
+        std::ostringstream comment;
+        comment << "Best of " << results.size() << " configurations on " << sweep_options.scrambles
+                << " scrambles x " << sweep_options.seeds << " seeds (corpus seed " << sweep_options.corpus_seed
+                << ")\nsolved " << best.solved << "/" << best.runs << ", median " << best.median_seconds
+                << " s, p95 " << best.p95_seconds << " s, median " << best.median_moves << " moves";
+        if (!best.config.save(sweep_path, comment.str())) {
+            std::cerr << "Could not write " << sweep_path << std::endl;
+            return 1;
+        }
+        std::cout << "Best configuration written to " << sweep_path << std::endl;
+        return 0;
     }
 
-    std::string rnd_orientation() {
-        return ORIENTATIONS[rand() % ORIENTATIONS.size()];
+    if (!client_path.empty()) {
+        return run_client(client_path, std::cin, std::cout);
+    }
+    if (!daemon_path.empty()) {
+        SolverDaemon::Config daemon_config;
+        daemon_config.workers = workers;
+        daemon_config.timeout = timeout;
+        daemon_config.genetic = config;
+        return SolverDaemon(daemon_path, daemon_config).run();
     }
 
-public:
-    Solver(int population_size, int max_generations, int max_resets, int elitism_num)
-        : population_size(population_size), max_generations(max_generations),
-          max_resets(max_resets), elitism_num(elitism_num) {}
-
-    void solve(const std::vector<std::string>& scramble, bool verbose = false) {
-        time_t start_time = time(nullptr);
-
-        if (verbose) {
-            std::cout << "Starting..." << std::endl;
-        }
-
-        for (int r = 0; r < max_resets; ++r) {
-            // Initialize population
-            std::vector<Cube> cubes;
-            for (int i = 0; i < population_size; ++i) {
-                Cube cube;
-                cube.execute(scramble);
-                cube.execute({rnd_single_move()});
-                cube.execute({rnd_single_move()});
-                cubes.push_back(cube);
-            }
-
-            for (int g = 0; g < max_generations; ++g) {
-                // Sort by fitness
-                std::sort(cubes.begin(), cubes.end());
-
-                if (verbose) {
-                    if (last_printed_world != r + 1) { // Only print when the world changes
-                        std::cout << "World: " << r+1 << std::endl;
-                        last_printed_world = r + 1;
-                    }
-                    std::cout << "\tGeneration: " << g + 1 
-                            << "\tIncorrect stickers: " << cubes[0].fitness << std::endl;
-                }
-
-
-                for (int i = 0; i < cubes.size(); ++i) {
-                    if (cubes[i].fitness == 0) {
-                        std::cout << "" << std::endl;
-                        std::cout << "====================================" << std::endl;
-                        std::cout << "SOLUTION FOUND" << std::endl;
-                        std::cout << "====================================" << std::endl;
-                        std::cout << "" << std::endl;
-                        std::cout << "World: " << r + 1 << " - Generation: " << g + 1 << std::endl;
-                        std::cout << "" << std::endl;
-                        std::cout << "Scramble: " << cubes[i].get_scramble_str() << std::endl;
-                        std::cout << "" << std::endl;
-                        std::cout << "Solution: " << cubes[i].get_algorithm_str() << std::endl;
-                        std::cout << "" << std::endl;
-                        std::cout << "Moves: " << cubes[i].get_algorithm().size() << std::endl;
-                        std::cout << "Time taken: " << difftime(time(nullptr), start_time) << " seconds" << std::endl;
-                        return;
-                    }
-
-                    if (i > elitism_num) {
-                        cubes[i] = copyCube(cubes[rand() % (elitism_num + 1)]);
-                        int evolution_type = rand() % 6;
-                        switch (evolution_type) {
-                            // Your evolution types translated to C++ switch-case
-                            // You may need to adjust as per actual behavior
-                            case 0:
-                                cubes[i].execute(rnd_permutation());
-                                break;
-                            case 1:
-                                cubes[i].execute(rnd_permutation());
-                                cubes[i].execute(rnd_permutation());
-                                break;
-                            case 2:
-                                cubes[i].execute({rnd_full_rotation()});
-                                cubes[i].execute(rnd_permutation());
-                                break;
-                            case 3:
-                                cubes[i].execute({rnd_orientation()});
-                                cubes[i].execute(rnd_permutation());
-                                break;
-                            case 4:
-                                cubes[i].execute({rnd_full_rotation()});
-                                cubes[i].execute({rnd_orientation()});
-                                cubes[i].execute(rnd_permutation());
-                                break;
-                            case 5:
-                                cubes[i].execute({rnd_orientation()});
-                                cubes[i].execute({rnd_full_rotation()});
-                                cubes[i].execute(rnd_permutation());
-                                break;
-                            default:
-                                break;
-                        }
-                    }
-                }
-                
-                }
-                if (verbose) {
-                    std::cout << "------------------------------------" << std::endl;
-                    std::cout << "Resetting the world" << std::endl;
+    // Declared before the solver so it outlives it and drains on exit
+    std::unique_ptr<ProgressLog> progress_log;
+    if (log_format != "text" || !log_path.empty()) {
+        std::unique_ptr<LogSink> sink;
+        std::unique_ptr<std::ostream> file;
+        if (!log_path.empty()) {
+            file.reset(new std::ofstream(log_path));
+            if (!*file) {
+                std::cerr << "Could not open log file " << log_path << std::endl;
+                return 1;
             }
         }
-        std::cout << "Solution not found" << std::endl;
-        std::cout << "Time taken: " << difftime(time(nullptr), start_time) << " seconds" << std::endl;
+        if (log_format == "jsonl") {
+            sink.reset(file ? new JsonlSink(std::move(file)) : new JsonlSink(std::cout));
+        } else if (log_format == "text") {
+            sink.reset(file ? new TextSink(std::move(file)) : new TextSink(std::cout));
+        } else {
+            std::cerr << "Unknown log format " << log_format << std::endl;
+            return 1;
+        }
+        progress_log.reset(new ProgressLog(std::move(sink)));
     }
-};
-
-int main() {
-    srand(time(nullptr));
-    // Remove the comment when you use the desired scramble sequence
-    // std::vector<std::string> scramble = {"R'", "U'", "L2", "B2", "U2", "F", "L2", "B'", "L'", "B", "D", "R", "B", "F2", "L", "F", "R'", "B2", "F'", "L", "B'", "D", "B2", "R2", "D'", "U", "B2", "F'", "D", "R2"};
-    // std::vector<std::string> scramble = {"U2", "B'", "F", "L", "B'", "F2", "D'", "U", "B2", "R'", "U", "B'", "F", "U", "F'", "R'", "U2", "L'", "R'", "D", "F2", "R'", "F'", "D2", "L'", "R2", "B'", "D", "L", "U2"};
-    std::vector<std::string> scramble = {"B'", "R'", "U2", "B'", "F", "D2", "R2", "B", "F'", "L2", "R'", "B2", "D2", "L2", "F'", "U", "L", "B2", "D", "F", "L'", "F", "R", "B2", "D'", "U'", "B'", "L'", "B'", "F2"};
-    // std::vector<std::string> scramble = {"D'", "B2", "D2", "L2", "U'", "L", "R'", "F", "L2", "R2", "U'", "L2", "B'", "L", "D'", "B2", "R2", "B'", "R", "F", "U2", "R", "B2", "F'", "L'", "B2", "L2", "R", "F2", "L'"};
 
-    int population_size = 500;
-    int max_generations = 300;
-    int max_resets = 10;
-    int elitism_num = 50;
+    std::unique_ptr<SolverBase> solver;
+    if (two_phase) {
+        solver.reset(new TwoPhaseSolver(22, 0, "twophase_tables.bin", true));
+    } else {
+        Solver* genetic = new Solver(config, seed);
+        if (!checkpoint_path.empty()) {
+            genetic->enable_checkpoints(checkpoint_path, checkpoint_interval);
+        }
+        if (!resume_path.empty()) {
+            genetic->resume_from(resume_path);
+        }
+        if (progress_log) {
+            genetic->set_progress_log(progress_log.get());
+        }
+        solver.reset(genetic);
+    }
 
-    Solver solver(population_size, max_generations, max_resets, elitism_num);
+    CancellationToken token;
+    if (timeout > 0.0) {
+        token.set_timeout(timeout);
+    }
     // Uncomment the loop if you want to run the solver multiple times
     // for (int i = 0; i < 5; ++i) {
-    //     solver.solve(scramble, false);
+    //     print_result(solver->solve(scramble, false));
     // }
-    solver.solve(scramble, true);
+    print_result(solver->solve(scramble, true, &token));
+    if (progress_log && progress_log->dropped() > 0) {
+        std::cerr << "Progress log dropped " << progress_log->dropped() << " records" << std::endl;
+    }
 
     return 0;
 }